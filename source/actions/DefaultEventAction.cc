@@ -12,6 +12,7 @@
 #include "PersistencyManager.h"
 #include "IonizationHit.h"
 #include "FactoryBase.h"
+#include "RunTelemetry.h"
 
 #include <G4Event.hh>
 #include <G4VVisManager.hh>
@@ -57,6 +58,8 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
 
   void DefaultEventAction::BeginOfEventAction(const G4Event* /*event*/)
   {
+    RunTelemetry::Instance().BeginOfEvent();
+
     // Print out event number info
     if ((nevt_ % nupdate_) == 0) {
       G4cout << " >> Event no. " << nevt_  << G4endl;
@@ -69,6 +72,7 @@ REGISTER_CLASS(DefaultEventAction, G4UserEventAction)
   void DefaultEventAction::EndOfEventAction(const G4Event* event)
   {
     nevt_++;
+    RunTelemetry::Instance().EndOfEvent();
 
     // Determine whether total energy deposit in ionization sensitive
     // detectors is above threshold
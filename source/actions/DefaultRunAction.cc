@@ -9,6 +9,9 @@
 
 #include "DefaultRunAction.h"
 #include "FactoryBase.h"
+#include "RunTelemetry.h"
+#include "OpticalTermination.h"
+#include "ProfilingSteppingAction.h"
 
 #include <G4Run.hh>
 
@@ -31,10 +34,16 @@ DefaultRunAction::~DefaultRunAction()
 void DefaultRunAction::BeginOfRunAction(const G4Run* run)
 {
   G4cout << "### Run " << run->GetRunID() << " start." << G4endl;
+  RunTelemetry::Instance().BeginOfRun(run->GetRunID(),
+                                      run->GetNumberOfEventToBeProcessed());
+  OpticalTermination::ResetCounters();
 }
 
 
 void DefaultRunAction::EndOfRunAction(const G4Run* run)
 {
+  RunTelemetry::Instance().EndOfRun();
+  OpticalTermination::ReportCounters();
+  ProfilingSteppingAction::EndOfRun();
   G4cout << "### Run " << run->GetRunID() << " end." << G4endl;
 }
@@ -12,6 +12,7 @@
 #include "PersistencyManager.h"
 #include "IonizationHit.h"
 #include "FactoryBase.h"
+#include "RunTelemetry.h"
 
 #include <G4Event.hh>
 #include <G4VVisManager.hh>
@@ -73,6 +74,8 @@ REGISTER_CLASS(MuonsEventAction, G4UserEventAction)
 
   void MuonsEventAction::BeginOfEventAction(const G4Event* /*event*/)
   {
+    RunTelemetry::Instance().BeginOfEvent();
+
    // Print out event number info
     if ((nevt_ % nupdate_) == 0) {
       G4cout << " >> Event no. " << nevt_  << G4endl;
@@ -84,6 +87,7 @@ REGISTER_CLASS(MuonsEventAction, G4UserEventAction)
   void MuonsEventAction::EndOfEventAction(const G4Event* event)
   {
     nevt_++;
+    RunTelemetry::Instance().EndOfEvent();
 
     // Determine whether total energy deposit in ionization sensitive
     // detectors is above threshold
@@ -0,0 +1,239 @@
+// ----------------------------------------------------------------------------
+// nexus | ProfilingSteppingAction.cc
+//
+// This class profiles the simulation, accumulating the number of steps and
+// tracks (and, optionally, a sampled estimate of the CPU time) per particle,
+// logical volume and process limiting the step. A report sorted by cost is
+// printed at the end of each run and can also be written as CSV or JSON.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ProfilingSteppingAction.h"
+#include "FactoryBase.h"
+
+#include <G4Step.hh>
+#include <G4Track.hh>
+#include <G4ParticleDefinition.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VProcess.hh>
+#include <G4GenericMessenger.hh>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace nexus;
+
+REGISTER_CLASS(ProfilingSteppingAction, G4UserSteppingAction)
+
+ProfilingSteppingAction* ProfilingSteppingAction::instance_ = nullptr;
+
+
+namespace {
+
+  G4String ParticleName(const G4ParticleDefinition* p)
+  { return p ? p->GetParticleName() : G4String("UNKNOWN"); }
+
+  G4String VolumeName(const G4LogicalVolume* v)
+  { return v ? v->GetName() : G4String("UNKNOWN"); }
+
+  G4String ProcessName(const G4VProcess* p)
+  { return p ? p->GetProcessName() : G4String("UNKNOWN"); }
+
+}
+
+
+
+ProfilingSteppingAction::ProfilingSteppingAction():
+  G4UserSteppingAction(), msg_(0), output_file_(""),
+  time_sampling_(0), report_lines_(20),
+  last_key_{nullptr, nullptr, nullptr}, last_counters_(nullptr),
+  nsteps_(0), sampled_track_(nullptr)
+{
+  msg_ = new G4GenericMessenger(this, "/Actions/ProfilingSteppingAction/");
+
+  msg_->DeclareProperty("output_file", output_file_,
+                        "File (.csv or .json) where the profile table is written.");
+
+  G4GenericMessenger::Command& sampling_cmd =
+    msg_->DeclareProperty("time_sampling", time_sampling_,
+                          "Measure the time of one step out of this number (0 disables timing).");
+  sampling_cmd.SetParameterName("time_sampling", false);
+  sampling_cmd.SetRange("time_sampling>=0");
+
+  G4GenericMessenger::Command& lines_cmd =
+    msg_->DeclareProperty("report_lines", report_lines_,
+                          "Number of entries shown in the printed report.");
+  lines_cmd.SetParameterName("report_lines", false);
+  lines_cmd.SetRange("report_lines>=0");
+
+  instance_ = this;
+}
+
+
+
+ProfilingSteppingAction::~ProfilingSteppingAction()
+{
+  if (instance_ == this) instance_ = nullptr;
+  delete msg_;
+}
+
+
+
+void ProfilingSteppingAction::EndOfRun()
+{
+  if (!instance_) return;
+  instance_->Report();
+  instance_->Reset();
+}
+
+
+
+void ProfilingSteppingAction::Reset()
+{
+  table_.clear();
+  last_counters_ = nullptr;
+  sampled_track_ = nullptr;
+  nsteps_ = 0;
+}
+
+
+
+void ProfilingSteppingAction::UserSteppingAction(const G4Step* step)
+{
+  const G4Track* track = step->GetTrack();
+
+  Key key = {track->GetDefinition(),
+             step->GetPreStepPoint()->GetTouchableHandle()->GetVolume()->GetLogicalVolume(),
+             step->GetPostStepPoint()->GetProcessDefinedStep()};
+
+  if (!last_counters_ || !(key == last_key_)) {
+    Counters& counters = table_[key];
+    last_key_ = key;
+    last_counters_ = &counters;
+  }
+
+  ++last_counters_->steps;
+  if (track->GetCurrentStepNumber() == 1) ++last_counters_->tracks;
+
+  if (time_sampling_ <= 0) return;
+
+  // The time elapsed since the sampled step of the same track is an estimate
+  // of the time spent on this one, scaled by the sampling rate
+  if (sampled_track_) {
+    if (sampled_track_ == track) {
+      std::chrono::duration<G4double> elapsed =
+        std::chrono::steady_clock::now() - sample_start_;
+      last_counters_->time += elapsed.count() * time_sampling_;
+    }
+    sampled_track_ = nullptr;
+  }
+
+  if (++nsteps_ % time_sampling_ == 0) {
+    sampled_track_ = track;
+    sample_start_ = std::chrono::steady_clock::now();
+  }
+}
+
+
+
+void ProfilingSteppingAction::Report()
+{
+  if (table_.empty()) return;
+
+  std::vector<Table::const_iterator> entries;
+  G4long total_steps = 0, total_tracks = 0;
+  G4double total_time = 0.;
+  for (Table::const_iterator it = table_.begin(); it != table_.end(); ++it) {
+    entries.push_back(it);
+    total_steps  += it->second.steps;
+    total_tracks += it->second.tracks;
+    total_time   += it->second.time;
+  }
+
+  // Sort by estimated time if available, by number of steps otherwise
+  G4bool timed = time_sampling_ > 0 && total_time > 0.;
+  std::sort(entries.begin(), entries.end(),
+            [timed](Table::const_iterator a, Table::const_iterator b) {
+              if (timed && a->second.time != b->second.time)
+                return a->second.time > b->second.time;
+              return a->second.steps > b->second.steps;
+            });
+
+  // The table is formatted in its own stream, so as not to
+  // change the format of the output printed after it
+  std::ostringstream out;
+
+  out << "\n---------- Step profile: " << total_steps << " steps, "
+      << total_tracks << " tracks";
+  if (timed) out << ", " << total_time << " s (estimated)";
+  out << " ----------\n";
+
+  out << std::left << std::setw(16) << "Particle" << std::setw(28) << "Volume"
+      << std::setw(20) << "Process" << std::right << std::setw(14) << "Steps"
+      << std::setw(8) << "%" << std::setw(12) << "Tracks";
+  if (timed) out << std::setw(12) << "Time (s)" << std::setw(8) << "%";
+  out << "\n";
+
+  G4int nlines = std::min((G4int) entries.size(), report_lines_);
+  for (G4int i=0; i<nlines; ++i) {
+    const Key& k = entries[i]->first;
+    const Counters& c = entries[i]->second;
+    out << std::left << std::setw(16) << ParticleName(k.particle)
+        << std::setw(28) << VolumeName(k.volume)
+        << std::setw(20) << ProcessName(k.process) << std::right
+        << std::setw(14) << c.steps
+        << std::setw(8) << std::fixed << std::setprecision(2)
+        << 100. * c.steps / total_steps
+        << std::setw(12) << c.tracks;
+    if (timed)
+      out << std::setw(12) << std::setprecision(3) << c.time
+          << std::setw(8) << std::setprecision(2) << 100. * c.time / total_time;
+    out << std::defaultfloat << "\n";
+  }
+
+  G4cout << out.str() << std::flush;
+
+  if (output_file_ != "") WriteTable(entries);
+}
+
+
+
+void ProfilingSteppingAction::WriteTable
+(const std::vector<Table::const_iterator>& entries) const
+{
+  std::ofstream out(output_file_);
+  if (!out) {
+    G4Exception("[ProfilingSteppingAction]", "WriteTable()", JustWarning,
+                ("Cannot open output file " + output_file_).c_str());
+    return;
+  }
+
+  G4bool json = output_file_.size() >= 5 &&
+    output_file_.compare(output_file_.size()-5, 5, ".json") == 0;
+
+  if (json) out << "[\n";
+  else      out << "particle,volume,process,steps,tracks,time_s\n";
+
+  for (size_t i=0; i<entries.size(); ++i) {
+    const Key& k = entries[i]->first;
+    const Counters& c = entries[i]->second;
+    if (json) {
+      out << "  {\"particle\": \"" << ParticleName(k.particle)
+          << "\", \"volume\": \"" << VolumeName(k.volume)
+          << "\", \"process\": \"" << ProcessName(k.process)
+          << "\", \"steps\": " << c.steps << ", \"tracks\": " << c.tracks
+          << ", \"time_s\": " << c.time << "}"
+          << (i+1 < entries.size() ? ",\n" : "\n");
+    } else {
+      out << ParticleName(k.particle) << "," << VolumeName(k.volume) << ","
+          << ProcessName(k.process) << "," << c.steps << "," << c.tracks
+          << "," << c.time << "\n";
+    }
+  }
+
+  if (json) out << "]\n";
+}
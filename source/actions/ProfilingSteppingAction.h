@@ -0,0 +1,101 @@
+// ----------------------------------------------------------------------------
+// nexus | ProfilingSteppingAction.h
+//
+// This class profiles the simulation, accumulating the number of steps and
+// tracks (and, optionally, a sampled estimate of the CPU time) per particle,
+// logical volume and process limiting the step. A report sorted by cost is
+// printed at the end of each run and can also be written as CSV or JSON.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PROFILING_STEPPING_ACTION_H
+#define PROFILING_STEPPING_ACTION_H
+
+#include <G4UserSteppingAction.hh>
+#include <globals.hh>
+
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class G4Step;
+class G4Track;
+class G4ParticleDefinition;
+class G4LogicalVolume;
+class G4VProcess;
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  class ProfilingSteppingAction: public G4UserSteppingAction
+  {
+  public:
+    /// Constructor
+    ProfilingSteppingAction();
+    /// Destructor
+    ~ProfilingSteppingAction();
+
+    virtual void UserSteppingAction(const G4Step*);
+
+    /// Print (and write) the report of the run and reset the table
+    /// (invoked at the end of run, while the particles, volumes and
+    /// processes referenced by the table still exist)
+    static void EndOfRun();
+
+  private:
+    struct Key {
+      const G4ParticleDefinition* particle;
+      const G4LogicalVolume* volume;
+      const G4VProcess* process;
+
+      bool operator==(const Key& k) const
+      { return particle == k.particle && volume == k.volume && process == k.process; }
+    };
+
+    struct KeyHash {
+      size_t operator()(const Key& k) const
+      {
+        size_t h = std::hash<const void*>()(k.particle);
+        h = h * 31 + std::hash<const void*>()(k.volume);
+        return h * 31 + std::hash<const void*>()(k.process);
+      }
+    };
+
+    struct Counters {
+      G4long steps;
+      G4long tracks; ///< Tracks whose first step is in this entry
+      G4double time; ///< Estimated time (seconds) from the sampled steps
+    };
+
+    typedef std::unordered_map<Key, Counters, KeyHash> Table;
+
+    void Report();
+    void Reset();
+    void WriteTable(const std::vector<Table::const_iterator>&) const;
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4String output_file_; ///< CSV or JSON file (chosen by extension)
+    G4int time_sampling_;  ///< Time one step out of this number (0: no timing)
+    G4int report_lines_;   ///< Number of entries printed in the report
+
+    Table table_;
+
+    // Entry of the previous step, reused while the key does not change
+    Key last_key_;
+    Counters* last_counters_;
+
+    G4long nsteps_;
+    const G4Track* sampled_track_;
+    std::chrono::steady_clock::time_point sample_start_;
+
+    static ProfilingSteppingAction* instance_;
+  };
+
+} // namespace nexus
+
+#endif
@@ -9,6 +9,7 @@
 
 #include "SaveAllEventAction.h"
 #include "FactoryBase.h"
+#include "RunTelemetry.h"
 
 #include <G4Event.hh>
 #include <G4VVisManager.hh>
@@ -35,6 +36,8 @@ REGISTER_CLASS(SaveAllEventAction, G4UserEventAction)
 
   void SaveAllEventAction::BeginOfEventAction(const G4Event* /*event*/)
   {
+    RunTelemetry::Instance().BeginOfEvent();
+
     // Print out event number info
     if ((nevt_ % nupdate_) == 0) {
       G4cout << " >> Event no. " << nevt_ << G4endl;
@@ -47,6 +50,7 @@ REGISTER_CLASS(SaveAllEventAction, G4UserEventAction)
   void SaveAllEventAction::EndOfEventAction(const G4Event* event)
   {
     nevt_++;
+    RunTelemetry::Instance().EndOfEvent();
 
 
     // draw tracks in visual mode
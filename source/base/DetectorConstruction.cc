@@ -9,6 +9,7 @@
 #include "DetectorConstruction.h"
 
 #include "GeometryBase.h"
+#include "SensorRegistry.h"
 
 #include <G4Box.hh>
 #include <G4Material.hh>
@@ -45,7 +46,9 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
 
   // At this point the user should have loaded the configuration
   // parameters of the geometry or it will get built with the
-  // default values.
+  // default values. Geometries register their sensors while
+  // being constructed.
+  SensorRegistry::Clear();
   geometry_->Construct();
 
   // We define now the world volume as an empty box big enough
@@ -73,5 +76,9 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   new G4PVPlacement(0, G4ThreeVector(0,0,0),
 		    geometry_logic, geometry_logic->GetName(), world_logic, false, 0);
 
+  // Once the volume tree is complete, sensor positions can be
+  // expressed in global coordinates
+  SensorRegistry::ResolveGlobalPositions(world_physi);
+
   return world_physi;
 }
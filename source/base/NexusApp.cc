@@ -15,6 +15,7 @@
 #include "PersistencyManagerBase.h"
 #include "BatchSession.h"
 #include "FactoryBase.h"
+#include "RunTelemetry.h"
 
 #include <G4GenericPhysicsList.hh>
 #include <G4UImanager.hh>
@@ -25,16 +26,102 @@
 #include <G4UserTrackingAction.hh>
 #include <G4UserSteppingAction.hh>
 #include <G4UserStackingAction.hh>
+#include <G4Version.hh>
+#include <G4Event.hh>
+
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
 
 using namespace nexus;
 
 
+namespace {
+
+  void AddToHash(uint64_t& hash, const std::string& str)
+  {
+    for (unsigned char c: str) { hash ^= c; hash *= 1099511628211ULL; }
+  }
+
+  // Adds the commands of a macro, and of the macros it executes, to
+  // the hash. Commands that do not change the materials, cuts or physics
+  // processes are skipped, so that, for instance, jobs differing only
+  // in the output file or the number of events share the cache.
+  void HashMacro(uint64_t& hash, const G4String& filename, G4int depth)
+  {
+    const char* skipped[] = {"/nexus/persistency/", "/nexus/telemetry/",
+                             "/nexus/random_seed", "/nexus/startup_cache",
+                             "/nexus/seed_per_event", "/nexus/start_event",
+                             "/nexus/event_list",
+                             "/nexus/RegisterDelayedMacro", "/Generator/",
+                             "/Actions/", "/run/beamOn", "/control/",
+                             "/tracking/", "/event/", "/run/verbose",
+                             "/process/verbose"};
+    const std::string execute = "/control/execute";
+
+    // Guard against macros executing themselves
+    if (depth > 20) return;
+
+    std::ifstream file(filename);
+    std::string line;
+    while (std::getline(file, line)) {
+      size_t start = line.find_first_not_of(" \t");
+      if (start == std::string::npos || line[start] != '/') continue;
+      line = line.substr(start);
+
+      if (line.compare(0, execute.size(), execute) == 0) {
+        std::istringstream args(line.substr(execute.size()));
+        std::string macro;
+        if (args >> macro) {
+          AddToHash(hash, execute + " " + macro + "\n");
+          HashMacro(hash, macro, depth + 1);
+        }
+        continue;
+      }
+
+      G4bool skip = false;
+      for (auto prefix: skipped)
+        if (line.compare(0, strlen(prefix), prefix) == 0) { skip = true; break; }
+      if (!skip) AddToHash(hash, line + "\n");
+    }
+  }
+
+  // Removes a directory and the files in it
+  void RemoveDirectory(const G4String& path)
+  {
+    DIR* dir = opendir(path.data());
+    if (dir) {
+      while (dirent* entry = readdir(dir)) {
+        G4String name = entry->d_name;
+        if (name == "." || name == "..") continue;
+        std::remove((path + "/" + name).data());
+      }
+      closedir(dir);
+    }
+    rmdir(path.data());
+  }
+
+}
+
+
 
 NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
                                          geo_name_(""), pm_name_(""),
                                          runact_name_(""), evtact_name_(""),
                                          stepact_name_(""), trkact_name_(""),
-                                         stkact_name_("")
+                                         stkact_name_(""),
+                                         init_macro_(init_macro),
+                                         cache_dir_(""), cache_path_(""),
+                                         store_tables_(false), seed_(0),
+                                         seed_per_event_(false), start_event_(0),
+                                         events_done_(0)
 {
   // Create and configure a generic messenger for the app
   msg_ = new G4GenericMessenger(this, "/nexus/", "Nexus control commands.");
@@ -53,6 +140,26 @@ NexusApp::NexusApp(G4String init_macro): G4RunManager(), gen_name_(""),
   msg_->DeclareMethod("random_seed", &NexusApp::SetRandomSeed,
                       "Set a seed for the random number generator.");
 
+  // Define the commands to seed each event individually, with a state
+  // derived from the seed and the event ID, so that events can be
+  // reproduced independently of the rest of the run
+  msg_->DeclareProperty("seed_per_event", seed_per_event_,
+                        "Derive the random state of each event from the seed and the event ID.");
+  msg_->DeclareMethod("start_event", &NexusApp::SetStartEvent,
+                      "ID of the first event. Events are seeded individually.");
+  msg_->DeclareMethod("event_list", &NexusApp::AddEvents,
+                      "IDs of the events to be processed (sorted, without repetitions). Events are seeded individually.");
+
+  // Define a command to set the directory of the startup cache, where
+  // the physics tables are stored for each configuration and from
+  // where they are retrieved in later jobs with the same configuration.
+  msg_->DeclareProperty("startup_cache", cache_dir_,
+                        "Directory of the cache of physics tables.");
+
+  // Create the run telemetry, so that its commands
+  // are available in the configuration macros
+  RunTelemetry::Instance();
+
 // Define the command to set the desired generator
   msg_->DeclareProperty("RegisterGenerator", gen_name_, "");
 
@@ -174,6 +281,18 @@ void NexusApp::Initialize()
     ExecuteMacroFile(macros_[i].data());
   }
 
+  if (cache_dir_ != "") {
+    cache_path_ = cache_dir_ + "/" + ConfigurationHash();
+    // The tag file is written once the tables are completely stored
+    std::ifstream tag(cache_path_ + "/complete");
+    if (tag.good()) {
+      G4cout << "### Retrieving physics tables from " << cache_path_ << G4endl;
+      physicsList->SetPhysicsTableRetrieved(cache_path_);
+    } else {
+      store_tables_ = true;
+    }
+  }
+
   G4RunManager::Initialize();
 
   for (unsigned int j=0; j<delayed_.size(); j++) {
@@ -183,6 +302,138 @@ void NexusApp::Initialize()
 
 
 
+void NexusApp::RunInitialization()
+{
+  // The physics tables are built (or retrieved)
+  // in the initialization of the first run
+  G4RunManager::RunInitialization();
+
+  if (seed_per_event_) {
+    // The seed is needed to reproduce the events, and the output
+    // keeps their IDs so that they can be processed again
+    PersistencyManagerBase* pm = dynamic_cast<PersistencyManagerBase*>
+      (G4VPersistencyManager::GetPersistencyManager());
+    if (pm) {
+      pm->SetRunInfo("random_seed", std::to_string(seed_));
+      pm->UseEventID(true);
+    }
+  }
+
+  if (!store_tables_) return;
+  store_tables_ = false;
+
+  // The tables are stored in a directory of this job and then renamed
+  // to the cache entry, so that jobs starting at the same time with the
+  // same configuration never write to (or read) the same directory.
+  // Renaming fails if another job stored the entry first, which is kept.
+  G4String tmp_path = cache_path_ + ".tmp" + std::to_string(getpid());
+  mkdir(cache_dir_.data(), 0755);
+  RemoveDirectory(tmp_path);
+  mkdir(tmp_path.data(), 0755);
+
+  G4cout << "### Storing physics tables in " << cache_path_ << G4endl;
+  if (!physicsList->StorePhysicsTable(tmp_path)) {
+    RemoveDirectory(tmp_path);
+    G4Exception("[NexusApp]", "RunInitialization()", JustWarning,
+                ("Physics tables could not be stored in " + cache_path_).c_str());
+    return;
+  }
+
+  {
+    std::ofstream tag(tmp_path + "/complete");
+    tag << G4Version << std::endl;
+  }
+
+  if (rename(tmp_path.data(), cache_path_.data()) != 0) {
+    RemoveDirectory(tmp_path);
+    G4cout << "### Physics tables already stored in " << cache_path_
+           << " by another job" << G4endl;
+  }
+}
+
+
+
+G4String NexusApp::ConfigurationHash() const
+{
+  // 64-bit FNV-1a hash, stable across platforms and compilers
+  uint64_t hash = 14695981039346656037ULL;
+
+  // The tables depend on the Geant4 and nexus builds as well
+  // as on the configuration: the executable itself is hashed
+  // (or, failing that, the build time of this file)
+  AddToHash(hash, std::to_string(G4VERSION_NUMBER));
+  std::ifstream exe("/proc/self/exe", std::ifstream::binary);
+  if (exe.good()) {
+    std::vector<char> buffer(1 << 20);
+    while (exe.read(buffer.data(), buffer.size()) || exe.gcount() > 0)
+      AddToHash(hash, std::string(buffer.data(), exe.gcount()));
+  } else {
+    AddToHash(hash, __DATE__ " " __TIME__);
+  }
+
+  HashMacro(hash, init_macro_, 0);
+  for (auto& filename: macros_) HashMacro(hash, filename, 0);
+
+  std::ostringstream str;
+  str << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return str.str();
+}
+
+
+
+void NexusApp::BeamOn(G4int n_event, const char* macro_file, G4int n_select)
+{
+  if (n_event > 0 && !event_list_.empty()) {
+    G4int remaining = event_list_.size() - events_done_;
+    if (remaining <= 0)
+      G4Exception("[NexusApp]", "BeamOn()", FatalException,
+                  "All the events of the event list have already been processed.");
+    if (n_event != remaining) {
+      G4cout << "### Processing the " << remaining
+             << " remaining events of the event list" << G4endl;
+      n_event = remaining;
+    }
+  }
+
+  G4RunManager::BeamOn(n_event, macro_file, n_select);
+
+  // Later runs continue the sequence of event IDs
+  // instead of generating the same events again
+  if (seed_per_event_ && n_event > 0) events_done_ += n_event;
+}
+
+
+
+G4Event* NexusApp::GenerateEvent(G4int i_event)
+{
+  if (!seed_per_event_) return G4RunManager::GenerateEvent(i_event);
+
+  G4int index = events_done_ + i_event;
+  G4int event_id = event_list_.empty() ? start_event_ + index : event_list_[index];
+
+  // The state of the engine is derived from the seed and the event ID
+  // hashing them with the SplitMix64 function, a bijection of 64-bit
+  // integers that spreads nearby inputs (e.g., consecutive IDs) apart
+  auto splitmix = [](uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+  };
+  uint64_t hash = splitmix(splitmix(seed_) ^ static_cast<uint64_t>(event_id));
+
+  // The seeds must be positive for some engines; the list ends with a zero
+  long seeds[3] = {static_cast<long>(hash & 0x7FFFFFFF),
+                   static_cast<long>((hash >> 32) & 0x7FFFFFFF), 0};
+  CLHEP::HepRandom::setTheSeeds(seeds);
+
+  // The event is created with its ID, which is therefore
+  // already set when the primary particles are generated
+  return G4RunManager::GenerateEvent(event_id);
+}
+
+
+
 void NexusApp::ExecuteMacroFile(const char* filename)
 {
   G4UImanager* UI = G4UImanager::GetUIpointer();
@@ -200,6 +451,36 @@ void NexusApp::SetRandomSeed(G4int seed)
   // Set the seed chosen by the user for the pseudo-random number
   // generator unless a negative number was provided, in which case
   // we will set as seed the system time.
-  if (seed < 0) CLHEP::HepRandom::setTheSeed(time(0));
-  else CLHEP::HepRandom::setTheSeed(seed);
+  seed_ = (seed < 0) ? time(0) : seed;
+  CLHEP::HepRandom::setTheSeed(seed_);
+}
+
+
+
+void NexusApp::SetStartEvent(G4int event_id)
+{
+  start_event_ = event_id;
+  events_done_ = 0;
+  seed_per_event_ = true;
+}
+
+
+
+void NexusApp::AddEvents(G4String ids)
+{
+  std::istringstream str(ids);
+  G4int event_id;
+  while (str >> event_id) event_list_.push_back(event_id);
+
+  if (!str.eof())
+    G4Exception("[NexusApp]", "AddEvents()", FatalException,
+                ("Invalid event ID in event list: " + ids).c_str());
+
+  // Events are processed in increasing order of ID, and only once
+  // each, so that the output keeps them sorted and unique
+  std::sort(event_list_.begin(), event_list_.end());
+  event_list_.erase(std::unique(event_list_.begin(), event_list_.end()),
+                    event_list_.end());
+
+  seed_per_event_ = true;
 }
@@ -35,6 +35,19 @@ namespace nexus {
 
     virtual void Initialize();
 
+    /// Builds the physics tables, storing them in the startup
+    /// cache the first time a given configuration is run
+    virtual void RunInitialization();
+
+    /// Processes the events of the event list, if any,
+    /// instead of the given number of events
+    virtual void BeamOn(G4int n_event, const char* macro_file=0,
+                        G4int n_select=-1);
+
+    /// Seeds the random number generator for the event, if events
+    /// are seeded individually, before generating it
+    virtual G4Event* GenerateEvent(G4int i_event);
+
     /// Returns the number of events to be processed in the current run
     G4int GetNumberOfEventsToBeProcessed() const;
 
@@ -49,6 +62,19 @@ namespace nexus {
     /// If a negative value is chosen, the system time is set as seed.
     void SetRandomSeed(G4int);
 
+    /// Set the ID of the first event of the run. Events are
+    /// then seeded individually, so that any range of events
+    /// can be reproduced independently of the rest.
+    void SetStartEvent(G4int);
+
+    /// Add the IDs (separated by blanks) of events to be
+    /// processed. Events are then seeded individually.
+    void AddEvents(G4String);
+
+    /// Returns a hash of the commands of the initialization and
+    /// configuration macros that may affect the physics tables
+    G4String ConfigurationHash() const;
+
   private:
     G4GenericMessenger* msg_;
     G4String gen_name_; ///< Name of the chosen primary generator
@@ -60,9 +86,20 @@ namespace nexus {
     G4String trkact_name_; ///< Name of the chosen tracking action
     G4String stkact_name_; ///< Name of the chosen stacking action
 
+    G4String init_macro_;
     std::vector<G4String> macros_;
     std::vector<G4String> delayed_;
 
+    G4String cache_dir_;  ///< Directory of the startup cache
+    G4String cache_path_; ///< Cache entry of the current configuration
+    G4bool store_tables_; ///< Store the tables at the first run
+
+    G4long seed_;           ///< Seed of the random number generator
+    G4bool seed_per_event_; ///< Derive the random state of each event from its ID
+    G4int start_event_;     ///< ID of the first event
+    std::vector<G4int> event_list_; ///< IDs of the events to be processed
+    G4int events_done_;     ///< Events generated in previous runs
+
   };
 
   // INLINE DEFINITIONS ////////////////////////////////////
@@ -0,0 +1,239 @@
+// ----------------------------------------------------------------------------
+// nexus | RunTelemetry.cc
+//
+// This class writes periodic progress records of the run, in JSON lines
+// format, to a file or to the standard error. Each record contains the
+// number of events processed, the throughput and estimated time to
+// completion, memory usage, time spent per stage and the amount of data
+// written, so that batch jobs can be monitored.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "RunTelemetry.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+
+#include <unistd.h>
+#include <sys/resource.h>
+
+using namespace nexus;
+
+
+namespace {
+
+  G4double Seconds(const std::chrono::steady_clock::duration& d)
+  {
+    return std::chrono::duration<G4double>(d).count();
+  }
+
+  /// Resident set size of the process in MB (negative if unknown)
+  G4double CurrentRSS()
+  {
+    long pages = 0, resident = 0;
+    std::ifstream statm("/proc/self/statm");
+    if (!(statm >> pages >> resident)) return -1.;
+    return resident * (G4double) sysconf(_SC_PAGESIZE) / (1024. * 1024.);
+  }
+
+  /// Peak resident set size of the process in MB
+  G4double PeakRSS()
+  {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1.;
+    return usage.ru_maxrss / 1024.;
+  }
+
+  G4String Number(G4double x)
+  {
+    if (x < 0.) return "null";
+    std::ostringstream s;
+    s << std::setprecision(6) << x;
+    return s.str();
+  }
+
+}
+
+
+
+RunTelemetry& RunTelemetry::Instance()
+{
+  static RunTelemetry instance;
+  return instance;
+}
+
+
+
+RunTelemetry::RunTelemetry():
+  msg_(0), output_(""), interval_(60. * second), window_(600. * second),
+  open_(false), run_id_(0), nevents_total_(0), nevents_(0),
+  generation_time_(0.), tracking_time_(0.), store_time_(0.), bytes_(0)
+{
+  msg_ = new G4GenericMessenger(this, "/nexus/telemetry/",
+                                "Control commands of the run telemetry.");
+
+  msg_->DeclareProperty("output", output_,
+                        "File where the telemetry records are written ('stderr' for the standard error).");
+
+  G4GenericMessenger::Command& interval_cmd =
+    msg_->DeclareProperty("interval", interval_,
+                          "Minimum time between telemetry records.");
+  interval_cmd.SetUnitCategory("Time");
+  interval_cmd.SetParameterName("interval", false);
+  interval_cmd.SetRange("interval>=0.");
+
+  G4GenericMessenger::Command& window_cmd =
+    msg_->DeclareProperty("window", window_,
+                          "Time window over which the event rate is computed.");
+  window_cmd.SetUnitCategory("Time");
+  window_cmd.SetParameterName("window", false);
+  window_cmd.SetRange("window>0.");
+}
+
+
+
+RunTelemetry::~RunTelemetry()
+{
+  if (file_.is_open()) file_.close();
+  delete msg_;
+}
+
+
+
+void RunTelemetry::Open()
+{
+  open_ = true;
+  if (output_ == "stderr") return;
+
+  file_.open(output_, std::ios::app);
+  if (!file_) {
+    G4Exception("[RunTelemetry]", "Open()", JustWarning,
+                ("Cannot open telemetry file " + output_ + ". Telemetry is disabled.").c_str());
+    output_ = "";
+  }
+}
+
+
+
+void RunTelemetry::BeginOfRun(G4int run_id, G4int nevents)
+{
+  if (!IsEnabled()) return;
+  if (!open_) Open();
+  if (!IsEnabled()) return;
+
+  run_id_ = run_id;
+  nevents_total_ = nevents;
+  nevents_ = 0;
+  generation_time_ = tracking_time_ = store_time_ = 0.;
+
+  run_start_ = last_record_ = mark_ = Clock::now();
+  history_.clear();
+  history_.push_back(std::make_pair(0., 0L));
+
+  Write("run_start");
+}
+
+
+
+void RunTelemetry::EndOfRun()
+{
+  if (!IsEnabled()) return;
+  Write("run_end");
+}
+
+
+
+void RunTelemetry::BeginOfEvent()
+{
+  if (!IsEnabled()) return;
+
+  // The primary generation happens before the event action is invoked
+  Clock::time_point now = Clock::now();
+  generation_time_ += Seconds(now - mark_);
+  mark_ = now;
+}
+
+
+
+void RunTelemetry::EndOfEvent()
+{
+  if (!IsEnabled()) return;
+
+  Clock::time_point now = Clock::now();
+  tracking_time_ += Seconds(now - mark_);
+  mark_ = now;
+
+  ++nevents_;
+
+  if (Seconds(now - last_record_) * second >= interval_) {
+    last_record_ = now;
+    Write("progress");
+  }
+}
+
+
+
+void RunTelemetry::EndOfStore(G4double seconds,
+                              const std::map<G4String, G4long>& rows, G4long bytes)
+{
+  if (!IsEnabled()) return;
+
+  store_time_ += seconds;
+  rows_  = rows;
+  bytes_ = bytes;
+  mark_  = Clock::now();
+}
+
+
+
+void RunTelemetry::Write(const G4String& type)
+{
+  G4double elapsed = Seconds(Clock::now() - run_start_);
+
+  // Event rate in the sliding window
+  history_.push_back(std::make_pair(elapsed, nevents_));
+  while (history_.size() > 2 &&
+         elapsed - history_[1].first >= window_/second)
+    history_.pop_front();
+
+  G4double dt = elapsed - history_.front().first;
+  G4double rate = (dt > 0.) ? (nevents_ - history_.front().second) / dt : -1.;
+
+  G4double eta = -1.;
+  if (rate > 0. && nevents_total_ > 0)
+    eta = (nevents_total_ - nevents_) / rate;
+
+  std::ostringstream rec;
+  rec << std::setprecision(6)
+      << "{\"type\": \"" << type << "\""
+      << ", \"timestamp\": " << (long) std::time(0)
+      << ", \"run\": " << run_id_
+      << ", \"elapsed_s\": " << Number(elapsed)
+      << ", \"events_done\": " << nevents_
+      << ", \"events_total\": " << nevents_total_
+      << ", \"events_per_s\": " << Number(rate)
+      << ", \"eta_s\": " << Number(eta)
+      << ", \"rss_mb\": " << Number(CurrentRSS())
+      << ", \"peak_rss_mb\": " << Number(PeakRSS())
+      << ", \"time_s\": {\"generation\": " << Number(generation_time_)
+      << ", \"tracking\": " << Number(tracking_time_)
+      << ", \"store\": " << Number(store_time_) << "}"
+      << ", \"rows\": {";
+
+  for (auto it = rows_.begin(); it != rows_.end(); ++it)
+    rec << (it == rows_.begin() ? "" : ", ") << "\"" << it->first << "\": " << it->second;
+
+  rec << "}, \"bytes_written\": " << bytes_ << "}\n";
+
+  if (output_ == "stderr") {
+    std::cerr << rec.str() << std::flush;
+  } else {
+    file_ << rec.str() << std::flush;
+  }
+}
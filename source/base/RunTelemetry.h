@@ -0,0 +1,92 @@
+// ----------------------------------------------------------------------------
+// nexus | RunTelemetry.h
+//
+// This class writes periodic progress records of the run, in JSON lines
+// format, to a file or to the standard error. Each record contains the
+// number of events processed, the throughput and estimated time to
+// completion, memory usage, time spent per stage and the amount of data
+// written, so that batch jobs can be monitored.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef RUN_TELEMETRY_H
+#define RUN_TELEMETRY_H
+
+#include <globals.hh>
+
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <map>
+
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  class RunTelemetry
+  {
+  public:
+    /// Return the single instance of the class
+    static RunTelemetry& Instance();
+
+    /// Invoked by the run action
+    void BeginOfRun(G4int run_id, G4int nevents);
+    void EndOfRun();
+
+    /// Invoked by the event actions
+    void BeginOfEvent();
+    void EndOfEvent();
+
+    /// Invoked by the persistency manager after storing an event,
+    /// with the time spent, the rows written per table and the bytes written
+    void EndOfStore(G4double seconds,
+                    const std::map<G4String, G4long>& rows, G4long bytes);
+
+    G4bool IsEnabled() const;
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    RunTelemetry();
+    ~RunTelemetry();
+    RunTelemetry(const RunTelemetry&);
+
+    void Write(const G4String& type);
+    void Open();
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4String output_;   ///< Output file, "stderr" or empty (disabled)
+    G4double interval_; ///< Minimum time between records
+    G4double window_;   ///< Time window for the throughput
+
+    std::ofstream file_;
+    G4bool open_;
+
+    G4int run_id_;
+    G4int nevents_total_;
+    G4long nevents_;
+
+    Clock::time_point run_start_;
+    Clock::time_point last_record_;
+    Clock::time_point mark_; ///< End of the previous stage
+
+    G4double generation_time_, tracking_time_, store_time_;
+
+    std::map<G4String, G4long> rows_;
+    G4long bytes_;
+
+    /// Recent (time since run start, events done) points for the throughput
+    std::deque<std::pair<G4double, G4long> > history_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4bool RunTelemetry::IsEnabled() const { return output_ != ""; }
+
+} // namespace nexus
+
+#endif
@@ -93,6 +93,9 @@ namespace nexus {
     G4String GetFinalProcess() const;
     void SetFinalProcess(G4String);
 
+    // Return the statistical weight of the track at its creation
+    G4double GetWeight() const;
+
 
     // Trajectory points
 
@@ -132,6 +135,7 @@ namespace nexus {
 
     G4double length_;
     G4double edep_;
+    G4double weight_;
 
     G4String creator_process_;
     G4String final_process_;
@@ -222,6 +226,9 @@ inline G4String nexus::Trajectory::GetFinalProcess() const
 inline void nexus::Trajectory::SetFinalProcess(G4String fp)
 { final_process_ = fp; }
 
+inline G4double nexus::Trajectory::GetWeight() const
+{ return weight_; }
+
 inline G4String nexus::Trajectory::GetInitialVolume() const
 { return initial_volume_; }
 
@@ -0,0 +1,86 @@
+// ----------------------------------------------------------------------------
+// nexus | AngularBiasing.cc
+//
+// Importance sampling of emission directions towards a target sphere
+// (e.g., one enclosing the field cage). With probability given by the cone
+// fraction, directions are sampled uniformly within the cone subtended by
+// the sphere from the emission point; otherwise, isotropically.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "AngularBiasing.h"
+
+#include <G4GenericMessenger.hh>
+#include <G4RandomDirection.hh>
+#include <G4PhysicalConstants.hh>
+#include <Randomize.hh>
+
+using namespace nexus;
+
+
+AngularBiasing::AngularBiasing(const G4String& messenger_dir):
+  msg_(0), target_center_(0., 0., 0.), target_radius_(0.), cone_fraction_(0.9)
+{
+  msg_ = new G4GenericMessenger(this, messenger_dir,
+    "Control commands of the angular biasing of the emission.");
+
+  msg_->DeclarePropertyWithUnit("target_center", "mm", target_center_,
+    "Center of the sphere towards which emission is biased.");
+
+  G4GenericMessenger::Command& radius_cmd =
+    msg_->DeclarePropertyWithUnit("target_radius", "mm", target_radius_,
+      "Radius of the sphere towards which emission is biased (0 to disable biasing).");
+  radius_cmd.SetParameterName("target_radius", false);
+  radius_cmd.SetRange("target_radius>=0.");
+
+  G4GenericMessenger::Command& fraction_cmd =
+    msg_->DeclareProperty("cone_fraction", cone_fraction_,
+      "Fraction of the directions sampled within the cone of the target.");
+  fraction_cmd.SetParameterName("cone_fraction", false);
+  fraction_cmd.SetRange("cone_fraction>=0. && cone_fraction<=1.");
+}
+
+
+
+AngularBiasing::~AngularBiasing()
+{
+  delete msg_;
+}
+
+
+
+G4ThreeVector AngularBiasing::SampleDirection(const G4ThreeVector& origin,
+                                              G4double& weight) const
+{
+  G4ThreeVector axis = target_center_ - origin;
+  G4double distance = axis.mag();
+
+  // Inside the target sphere, emission is left isotropic
+  if (!IsEnabled() || distance <= target_radius_)
+    return G4RandomDirection();
+
+  G4double ratio = target_radius_ / distance;
+  G4double cos_max = std::sqrt(1. - ratio*ratio);
+
+  G4ThreeVector direction;
+  if (G4UniformRand() < cone_fraction_) {
+    G4double cos_theta = cos_max + (1. - cos_max) * G4UniformRand();
+    G4double sin_theta = std::sqrt(1. - cos_theta*cos_theta);
+    G4double phi = twopi * G4UniformRand();
+    direction.set(sin_theta * std::cos(phi), sin_theta * std::sin(phi), cos_theta);
+    direction.rotateUz(axis.unit());
+  }
+  else {
+    direction = G4RandomDirection();
+  }
+
+  // Ratio of the isotropic and the biased probability densities
+  G4double density = 1. - cone_fraction_;
+  if (direction.dot(axis) >= cos_max * distance)
+    density += 2. * cone_fraction_ / (1. - cos_max);
+
+  weight /= density;
+
+  return direction;
+}
@@ -0,0 +1,55 @@
+// ----------------------------------------------------------------------------
+// nexus | AngularBiasing.h
+//
+// Importance sampling of emission directions towards a target sphere
+// (e.g., one enclosing the field cage). With probability given by the cone
+// fraction, directions are sampled uniformly within the cone subtended by
+// the sphere from the emission point; otherwise, isotropically. The weight
+// returned with each direction (isotropic over biased probability density)
+// keeps the estimators unbiased, including for particles that reach the
+// target after scattering from outside the cone.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef ANGULAR_BIASING_H
+#define ANGULAR_BIASING_H
+
+#include <G4ThreeVector.hh>
+
+class G4GenericMessenger;
+
+
+namespace nexus {
+
+  class AngularBiasing
+  {
+  public:
+    /// Constructor, defining the configuration commands in the given
+    /// messenger directory
+    AngularBiasing(const G4String& messenger_dir);
+    /// Destructor
+    ~AngularBiasing();
+
+    /// Returns true if a target has been set
+    G4bool IsEnabled() const;
+
+    /// Returns a direction sampled for a particle emitted at the given
+    /// point, multiplying the weight by its statistical weight
+    G4ThreeVector SampleDirection(const G4ThreeVector& origin,
+                                  G4double& weight) const;
+
+  private:
+    G4GenericMessenger* msg_;
+
+    G4ThreeVector target_center_;
+    G4double target_radius_;
+    G4double cone_fraction_; ///< Fraction of directions sampled in the cone
+  };
+
+  inline G4bool AngularBiasing::IsEnabled() const
+  { return target_radius_ > 0.; }
+
+} // end namespace nexus
+
+#endif
@@ -6,7 +6,8 @@
 // FORTRAN package, with nexus.
 // It provides the primary vertex of a Xe-136 double beta decay.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta, or the faster indexed binary store produced from it
+// with nexus-genbb, is also allowed.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -16,6 +17,7 @@
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
 #include "FactoryBase.h"
+#include "PersistencyManagerBase.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4RunManager.hh>
@@ -23,13 +25,21 @@
 #include <G4ParticleDefinition.hh>
 #include "decay0.h"
 #include <iostream>
+#include <sstream>
+#include <algorithm>
 using namespace nexus;
 
+namespace {
+  /// Consecutive decays below threshold before giving up
+  const G4long max_failures = 100000000;
+}
+
 REGISTER_CLASS(Decay0Interface, G4VPrimaryGenerator)
 
 
 Decay0Interface::Decay0Interface():
-  G4VPrimaryGenerator(), msg_(0), opened_(false), geom_(0)
+  G4VPrimaryGenerator(), msg_(0), store_(0), start_event_(0), next_event_(-1),
+  opened_(false), resample_(false), trials_(0), accepted_(0), geom_(0)
 {
 
   msg_ = new G4GenericMessenger(this, "/Generator/Decay0Interface/",
@@ -37,8 +47,12 @@ Decay0Interface::Decay0Interface():
 
   msg_->DeclareMethod("inputFile", &Decay0Interface::OpenInputFile, "");
   msg_->DeclareProperty("region", region_, "");
+  msg_->DeclareProperty("start_event", start_event_,
+    "Index of the first event read from the input file (to split it among jobs).");
 
   msg_->DeclareMethod("EnergyThreshold", &Decay0Interface::SetEnergyThreshold, ""); // for electrons only.
+  msg_->DeclareProperty("resample_below_threshold", resample_,
+    "Generate decays until one is above the energy threshold, instead of leaving the event empty.");
   msg_->DeclareMethod("Xe136DecayMode", &Decay0Interface::SetXe136DecayMode, "");
   msg_->DeclareMethod("Ba136FinalState", &Decay0Interface::SetBa136FinalState, "");
 
@@ -56,6 +70,7 @@ Decay0Interface::Decay0Interface():
 Decay0Interface::~Decay0Interface()
 {
   if (file_.is_open()) file_.close();
+  delete store_;
   if (fOutDebug_.is_open()) fOutDebug_.close();
   if (decay0_ != 0) delete decay0_;
 }
@@ -70,6 +85,12 @@ void Decay0Interface::OpenInputFile(G4String filename)
      return;
    }
 
+  if (GenbbStore::IsGenbbStore(filename)) {
+    store_ = new GenbbStore(filename);
+    opened_ = true;
+    return;
+  }
+
   file_.open(filename.data());
 
   if (file_.good()) {
@@ -102,17 +123,34 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
      }
 
      std::vector<decay0Part> theParts;
-     decay0_->decay0DoIt(theParts);
-     //
-     // Keep the event only if the sum of the electron energies are above the threshold.
-     //
-     double eTotKin = 0.;
-     for(std::vector<decay0Part>::const_iterator itp = theParts.begin(); itp != theParts.end(); itp++) {
-
-       if (std::abs(itp->pdgCode_) == 11) eTotKin += itp->energy_;
-     }
-     const bool keepEvt = eTotKin > energyThreshold_;
-     myEventCounter_++;
+     bool keepEvt = false;
+     G4long failures = 0;
+
+     do {
+       decay0_->decay0DoIt(theParts);
+       //
+       // Keep the event only if the sum of the electron energies are above the threshold.
+       //
+       double eTotKin = 0.;
+       for(std::vector<decay0Part>::const_iterator itp = theParts.begin(); itp != theParts.end(); itp++) {
+
+         if (std::abs(itp->pdgCode_) == 11) eTotKin += itp->energy_;
+       }
+       keepEvt = eTotKin > energyThreshold_;
+       myEventCounter_++;
+       trials_++;
+
+       if (!keepEvt && ++failures == max_failures) {
+         G4Exception("[Decay0Interface]", "GeneratePrimaryVertex()", FatalException,
+           "No decay above the energy threshold after many trials.");
+       }
+       // With resampling, events below threshold are discarded
+       // until one passes it, so that no event is left empty
+     } while (resample_ && !keepEvt);
+
+     if (keepEvt) accepted_++;
+     if (resample_) ReportAcceptance();
+
      if (fOutDebug_.is_open() && keepEvt ) {
        int k = 0;
        for (std::vector<decay0Part>::const_iterator itp = theParts.begin(); itp != theParts.end(); itp++, k++) {
@@ -138,42 +176,33 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
      return;
    }
 
-  //G4cout << "GeneratePrimaryVertex()" << G4endl;
-
-  // reading event-related information
-  G4int entries;     // number of particles in the event
-  G4long evt_no;     // event number
-  G4double evt_time; // initial time in seconds
-
-  file_ >> evt_no >> evt_time >> entries;
-
+  const GenbbParticle* particles;
+  size_t entries;
 
-  // abort if end-of-file was reached in last operation
-  if (file_.eof()) {
+  // abort if end-of-file was reached
+  if (!NextEvent(particles, entries)) {
     G4cout  << "[Decay0Interface] End-of-File reached. "
             << "Aborting the run..." << G4endl;
     G4RunManager::GetRunManager()->AbortRun();
     return;
   }
 
-  //G4cout << "entries: " << entries << G4endl;
-
   // generate a position in the detector
   // (all primary particles will be generated there)
   particle_position = geom_->GenerateVertex(region_);
 
 
-  // reading info for each particle in the event
-  for (G4int i=0; i<entries; i++) {
-    //G4cout << i << G4endl;
-
-    G4int g3code;           // GEANT3 particle code
-    G4double px, py, pz;    // Momentum components in MeV
+  // info for each particle in the event
+  for (size_t i=0; i<entries; i++) {
 
-    file_ >> g3code >> px >> py >> pz >> particle_time;
+    // Momentum components are in MeV
+    G4double px = particles[i].px;
+    G4double py = particles[i].py;
+    G4double pz = particles[i].pz;
+    particle_time = particles[i].time;
 
     G4ParticleDefinition* g4code =
-      G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(g3code));
+      G4ParticleTable::GetParticleTable()->FindParticle(G3toPDG(particles[i].g3code));
 
     // create a primary particle
     G4PrimaryParticle* particle =
@@ -195,6 +224,75 @@ void Decay0Interface::GeneratePrimaryVertex(G4Event* event)
 
 
 
+G4bool Decay0Interface::NextEvent(const GenbbParticle*& particles, size_t& entries)
+{
+  if (next_event_ < 0) {
+    next_event_ = std::max(start_event_, 0);
+    // The ascii file can only be read forwards
+    if (!store_) {
+      for (G4long i=0; i<next_event_; i++)
+        if (!ReadTextEvent(text_event_)) return false;
+    }
+  }
+
+  if (store_) {
+    if (next_event_ >= (G4long) store_->GetNumberOfEvents()) return false;
+    particles = store_->GetEvent(next_event_, entries);
+  }
+  else {
+    if (!ReadTextEvent(text_event_)) return false;
+    particles = text_event_.data();
+    entries = text_event_.size();
+  }
+
+  next_event_++;
+  return true;
+}
+
+
+
+G4bool Decay0Interface::ReadTextEvent(std::vector<GenbbParticle>& particles)
+{
+  // reading event-related information
+  G4int entries;     // number of particles in the event
+  G4long evt_no;     // event number
+  G4double evt_time; // initial time in seconds
+
+  file_ >> evt_no >> evt_time >> entries;
+
+  if (file_.eof()) return false;
+
+  particles.resize(entries);
+
+  // reading info for each particle in the event
+  for (G4int i=0; i<entries; i++) {
+    GenbbParticle& p = particles[i];
+    file_ >> p.g3code >> p.px >> p.py >> p.pz >> p.time;
+  }
+
+  return true;
+}
+
+
+
+void Decay0Interface::ReportAcceptance()
+{
+  // The fraction of decays above threshold is needed to normalise rates
+  PersistencyManagerBase* pm = dynamic_cast<PersistencyManagerBase*>
+    (G4VPersistencyManager::GetPersistencyManager());
+  if (!pm) return;
+
+  std::ostringstream acceptance;
+  acceptance.precision(10);
+  acceptance << (G4double) accepted_ / trials_;
+
+  pm->SetRunInfo("decay0_trials", std::to_string(trials_));
+  pm->SetRunInfo("decay0_accepted", std::to_string(accepted_));
+  pm->SetRunInfo("decay0_acceptance", acceptance.str());
+}
+
+
+
 void Decay0Interface::ProcessHeader()
 {
   G4String line;
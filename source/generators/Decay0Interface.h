@@ -5,7 +5,8 @@
 // interfacing the DECAY0 c++ code, translated from the original
 // FORTRAN package, with nexus.
 // The possibility of reading a previously generated ascii file with the
-// electron momenta is also allowed.
+// electron momenta, or the faster indexed binary store produced from it
+// with nexus-genbb, is also allowed.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,8 +14,11 @@
 #ifndef DECAY0_INTERFACE_H
 #define DECAY0_INTERFACE_H
 
+#include "GenbbStore.h"
+
 #include <G4VPrimaryGenerator.hh>
 #include <fstream>
+#include <vector>
 
 class G4GenericMessenger;
 class G4Event;
@@ -43,10 +47,19 @@ namespace nexus {
     void GeneratePrimaryVertex(G4Event*);
 
   private:
-    /// Open the Decay0 input file selected by the user
+    /// Open the Decay0 input file (ascii or binary store) selected by the user
     void OpenInputFile(G4String);
     /// Parse information in the file header
     void ProcessHeader();
+    /// Read the next event of the ascii file. Returns false at the end of file.
+    G4bool ReadTextEvent(std::vector<GenbbParticle>&);
+    /// Get the particles of the next event of the input file,
+    /// skipping the events before start_event_ the first time.
+    /// Returns false at the end of the file.
+    G4bool NextEvent(const GenbbParticle*&, size_t&);
+    /// Write the fraction of decays above the energy
+    /// threshold to the run configuration
+    void ReportAcceptance();
 
     /// Return the PDG code equivalent to a given GEANT3 particle code
     G4int G3toPDG(const G4int);
@@ -55,6 +68,10 @@ namespace nexus {
     G4GenericMessenger* msg_;
 
     std::ifstream file_; ///< ASCII file produced by Decay0
+    GenbbStore* store_;  ///< Binary store, if given instead of an ascii file
+    std::vector<GenbbParticle> text_event_; ///< Last event read from file_
+    G4int start_event_;  ///< Index of the first event read from the file
+    G4long next_event_;  ///< Index of the next event, -1 before the first one
     G4String region_; ///< region of generation of vertices in geometry
 
     G4bool opened_;
@@ -68,6 +85,9 @@ namespace nexus {
 			  // default is 0 (ground state)
 
     double energyThreshold_;
+    G4bool resample_;  ///< Resample decays below the energy threshold
+    G4long trials_;    ///< Number of decays generated
+    G4long accepted_;  ///< Number of decays above the energy threshold
 
     std::ofstream fOutDebug_; // for debugging...
     const GeometryBase* geom_;
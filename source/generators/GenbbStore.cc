@@ -0,0 +1,91 @@
+// ----------------------------------------------------------------------------
+// nexus | GenbbStore.cc
+//
+// Memory-mapped reader of indexed binary genbb event stores, produced from
+// genbb (Decay0) ascii files with nexus-genbb. Any event can be accessed in
+// constant time, so that different jobs can read disjoint slices of the
+// same store.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "GenbbStore.h"
+
+#include <globals.hh>
+
+#include <fstream>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace nexus;
+
+
+GenbbStore::GenbbStore(const std::string& filename):
+  map_addr_(nullptr), map_size_(0), header_(nullptr),
+  particles_(nullptr), index_(nullptr)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) close(fd);
+    G4String msg = "Cannot open genbb store " + filename;
+    G4Exception("[GenbbStore]", "GenbbStore()", FatalException, msg);
+    return;
+  }
+
+  map_size_ = st.st_size;
+  map_addr_ = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (map_addr_ == MAP_FAILED) {
+    map_addr_ = nullptr;
+    G4String msg = "Cannot memory-map genbb store " + filename;
+    G4Exception("[GenbbStore]", "GenbbStore()", FatalException, msg);
+    return;
+  }
+
+  header_ = static_cast<const GenbbStoreHeader*>(map_addr_);
+  const char* base = static_cast<const char*>(map_addr_);
+
+  G4bool valid = map_size_ >= sizeof(GenbbStoreHeader) &&
+    std::memcmp(header_->magic, genbb_store_magic, sizeof(genbb_store_magic)) == 0 &&
+    header_->version == genbb_store_version &&
+    header_->record_size == sizeof(GenbbParticle) &&
+    header_->index_offset == sizeof(GenbbStoreHeader) +
+                             header_->nparticles * sizeof(GenbbParticle) &&
+    map_size_ == header_->index_offset + (header_->nevents + 1) * sizeof(uint64_t);
+
+  if (valid) {
+    particles_ = reinterpret_cast<const GenbbParticle*>(base + sizeof(GenbbStoreHeader));
+    index_ = reinterpret_cast<const uint64_t*>(base + header_->index_offset);
+    valid = index_[0] == 0 && index_[header_->nevents] == header_->nparticles;
+  }
+
+  if (!valid) {
+    munmap(map_addr_, map_size_);
+    map_addr_ = nullptr;
+    G4String msg = filename + " is not a valid genbb store.";
+    G4Exception("[GenbbStore]", "GenbbStore()", FatalException, msg);
+  }
+}
+
+
+
+GenbbStore::~GenbbStore()
+{
+  if (map_addr_) munmap(map_addr_, map_size_);
+}
+
+
+
+bool GenbbStore::IsGenbbStore(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  char magic[sizeof(genbb_store_magic)];
+  if (!file.read(magic, sizeof(magic))) return false;
+  return std::memcmp(magic, genbb_store_magic, sizeof(magic)) == 0;
+}
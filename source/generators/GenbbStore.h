@@ -0,0 +1,88 @@
+// ----------------------------------------------------------------------------
+// nexus | GenbbStore.h
+//
+// Memory-mapped reader of indexed binary genbb event stores, produced from
+// genbb (Decay0) ascii files with nexus-genbb. Any event can be accessed in
+// constant time, so that different jobs can read disjoint slices of the
+// same store.
+//
+// The store is a binary file with the following layout:
+//   - header (GenbbStoreHeader)
+//   - particle records of all events, one after another (GenbbParticle)
+//   - index: position of the first particle of each event in the list
+//     of particles, plus the total number of particles (nevents+1 uint64)
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef GENBB_STORE_H
+#define GENBB_STORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+
+namespace nexus {
+
+  /// Header of a genbb store
+  struct GenbbStoreHeader {
+    char     magic[8];     ///< "NXGENBB1"
+    uint32_t version;
+    uint32_t record_size;  ///< Size of the particle records
+    uint64_t nevents;      ///< Number of events
+    uint64_t nparticles;   ///< Number of particles of all events
+    uint64_t index_offset; ///< Position of the index in the file (bytes)
+  };
+
+  /// Particle of a genbb event, as found in the ascii file
+  struct GenbbParticle {
+    int32_t g3code;  ///< GEANT3 particle code
+    int32_t padding;
+    double  px;      ///< Momentum (MeV)
+    double  py;
+    double  pz;
+    double  time;    ///< Time shift from the previous particle (s)
+  };
+
+  const char genbb_store_magic[8] = {'N','X','G','E','N','B','B','1'};
+  const uint32_t genbb_store_version = 1;
+
+
+  class GenbbStore
+  {
+  public:
+    /// Constructor memory-mapping the given store
+    GenbbStore(const std::string& filename);
+    /// Destructor
+    ~GenbbStore();
+
+    /// Returns true if the file is a genbb store
+    static bool IsGenbbStore(const std::string& filename);
+
+    /// Returns the number of events of the store
+    size_t GetNumberOfEvents() const;
+
+    /// Returns the particles of an event and their number
+    const GenbbParticle* GetEvent(size_t event, size_t& nparticles) const;
+
+  private:
+    void*  map_addr_;
+    size_t map_size_;
+    const GenbbStoreHeader* header_;
+    const GenbbParticle* particles_;
+    const uint64_t* index_;
+  };
+
+  inline size_t GenbbStore::GetNumberOfEvents() const
+  { return header_->nevents; }
+
+  inline const GenbbParticle* GenbbStore::GetEvent(size_t event, size_t& nparticles) const
+  {
+    nparticles = index_[event+1] - index_[event];
+    return particles_ + index_[event];
+  }
+
+} // end namespace nexus
+
+#endif
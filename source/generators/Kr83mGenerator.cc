@@ -80,6 +80,14 @@ namespace nexus {
 
    std::cerr << " Kr83Generator::Kr83Generator, probability to emit an X-ray "
              << probability_Xrays_[probability_Xrays_.size() -1]*100. << " percent " << std::endl;
+
+   // Alias table for the selection of the X-ray: the first outcome
+   // is the emission of no X-ray, the rest follow energy_Xrays_
+   std::vector<G4double> weights(1, 1. - probability_Xrays_.back());
+   for (size_t k=0; k!= probability_Xrays_.size(); k++)
+     weights.push_back(probability_Xrays_[k] - (k ? probability_Xrays_[k-1] : 0.));
+   xray_sampler_.SetWeights(weights);
+
     /// For the moment, only random direction are allowed.
     // Since the transion are either E3, M4 (32 keV), E2, M1, (9 keV),
     // no strong asymmetry to start with..
@@ -124,19 +132,12 @@ namespace nexus {
    // Decide if we emit an X-ray..
    //
 
-    const double probXRay = G4UniformRand();
+    const size_t kSel = xray_sampler_.Sample();
     double eKin32 = energy_32_;
     double eXray = 0.;
-    if (probXRay < probability_Xrays_[probability_Xrays_.size() -1]) {
-      size_t kSel = probability_Xrays_.size() - 1;
-      for (size_t k=1; k!= probability_Xrays_.size(); k++) {
-        if ((probXRay >= probability_Xrays_[k-1]) && (probXRay < probability_Xrays_[k])) {
-          kSel = k-1;
-	  break;
-        }
-      }
-      eKin32 = energy_32_ - energy_Xrays_[kSel];
-      eXray = energy_Xrays_[kSel];
+    if (kSel > 0) {
+      eKin32 = energy_32_ - energy_Xrays_[kSel-1];
+      eXray = energy_Xrays_[kSel-1];
     }
 
     G4double mass = particle_defelectron_->GetPDGMass();
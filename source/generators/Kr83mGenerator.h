@@ -10,6 +10,8 @@
 #ifndef Kr83m_GENERATOR_H
 #define Kr83m_GENERATOR_H
 
+#include "RandomUtils.h"
+
 #include <vector>
 #include <G4VPrimaryGenerator.hh>
 
@@ -69,6 +71,7 @@ namespace nexus {
     std::vector<double> energy_Xrays_; // Energies of various X-ray, as the Kr83 atom relaxes to
     std::vector<double> probability_Xrays_; // Probability to emit an X-ray of the above energy, per decay.
                                             // We make cumulative, for easy access for random number.
+    AliasSampler xray_sampler_; // Selects the X-ray emitted, if any (outcome 0 means no X-ray)
 
     G4String region_;
     G4ParticleDefinition*  particle_defgamma_;
@@ -12,6 +12,7 @@
 #include "DetectorConstruction.h"
 #include "GeometryBase.h"
 #include "FactoryBase.h"
+#include "AngularBiasing.h"
 
 #include <G4Event.hh>
 #include <G4GenericMessenger.hh>
@@ -31,7 +32,7 @@ namespace nexus {
 
   using namespace CLHEP;
 
-  Na22Generator::Na22Generator() : geom_(0)
+  Na22Generator::Na22Generator() : geom_(0), biasing_(0)
   {
     /// For the moment, only random direction are allowed. To be fixes if needed
      msg_ = new G4GenericMessenger(this, "/Generator/Na22Generator/",
@@ -40,6 +41,8 @@ namespace nexus {
      msg_->DeclareProperty("region", region_,
 			   "Set the region of the geometry where the vertex will be generated.");
 
+     biasing_ = new AngularBiasing("/Generator/Na22Generator/biasing/");
+
 
     DetectorConstruction* detconst = (DetectorConstruction*)
       G4RunManager::GetRunManager()->GetUserDetectorConstruction();
@@ -48,6 +51,7 @@ namespace nexus {
 
   Na22Generator::~Na22Generator()
   {
+    delete biasing_;
   }
 
   void Na22Generator::GeneratePrimaryVertex(G4Event* evt)
@@ -58,6 +62,11 @@ namespace nexus {
     G4PrimaryVertex* vertex =
         new G4PrimaryVertex(position, time);
 
+    // The directions of the annihilation pair and of the disexcitation
+    // gamma are independent, so the weight of the event is the product
+    // of their weights (1 without biasing)
+    G4double weight = 1.;
+
     G4ParticleDefinition* particle_definition =
       G4ParticleTable::GetParticleTable()->FindParticle("gamma");
     // Set masses to PDG values
@@ -69,7 +78,7 @@ namespace nexus {
 
     if (rand < 0.903) {
 
-    G4ThreeVector momentum_direction = G4RandomDirection();
+    G4ThreeVector momentum_direction = biasing_->SampleDirection(position, weight);
 
     // Calculate cartesian components of momentum
     G4double energy = 510.999*keV + mass;
@@ -94,7 +103,7 @@ namespace nexus {
 
  }
 
-    G4ThreeVector momentum_direction_dis = G4RandomDirection();
+    G4ThreeVector momentum_direction_dis = biasing_->SampleDirection(position, weight);
 
     // Calculate cartesian components of momentum of disexcitation gamma
     G4double energy_dis = 1274.537*keV + mass;
@@ -112,6 +121,7 @@ namespace nexus {
     vertex->SetPrimary(gamma_dis);
 
 
+    vertex->SetWeight(weight);
     evt->AddPrimaryVertex(vertex);
   }
 
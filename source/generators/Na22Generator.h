@@ -19,6 +19,7 @@ class G4GenericMessenger;
 namespace nexus {
 
   class GeometryBase;
+  class AngularBiasing;
 
   class Na22Generator: public G4VPrimaryGenerator
   {
@@ -37,6 +38,7 @@ namespace nexus {
 
     G4String region_;
 
+    AngularBiasing* biasing_; ///< Biasing of the gamma directions
   };
 
 }// end namespace nexus
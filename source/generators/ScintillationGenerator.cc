@@ -14,6 +14,7 @@
 #include "GeometryBase.h"
 #include "OpticalMaterialProperties.h"
 #include "FactoryBase.h"
+#include "PhotonThinning.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4ParticleDefinition.hh>
@@ -91,7 +92,10 @@ void ScintillationGenerator::GeneratePrimaryVertex(G4Event* event)
   // Create a new vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
 
-  for ( G4int i = 0; i<nphotons_; i++)
+  // Only the photons surviving the thinning, if any, are generated
+  G4int nphotons = PhotonThinning::Thin(nphotons_);
+
+  for ( G4int i = 0; i<nphotons; i++)
     {
       // Generate random direction by default
       G4ThreeVector _momentum_direction = G4RandomDirection();
@@ -17,6 +17,7 @@
 #include "GeometryBase.h"
 #include "RandomUtils.h"
 #include "FactoryBase.h"
+#include "AngularBiasing.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4ParticleDefinition.hh>
@@ -39,7 +40,8 @@ REGISTER_CLASS(SingleParticleGenerator, G4VPrimaryGenerator)
 SingleParticleGenerator::SingleParticleGenerator():
 G4VPrimaryGenerator(), msg_(0), particle_definition_(0),
 energy_min_(0.), energy_max_(0.), geom_(0), momentum_{},
-costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi)
+costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi),
+biasing_(0)
 {
   msg_ = new G4GenericMessenger(this, "/Generator/SingleParticle/",
     "Control commands of single-particle generator.");
@@ -76,6 +78,7 @@ costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi)
   msg_->DeclareProperty("max_phi", phi_max_,
 			"Set maximum phi for the direction of the particle.");
 
+  biasing_ = new AngularBiasing("/Generator/SingleParticle/biasing/");
 
   DetectorConstruction* detconst = (DetectorConstruction*) G4RunManager::GetRunManager()->GetUserDetectorConstruction();
   geom_ = detconst->GetGeometry();
@@ -86,6 +89,7 @@ costheta_min_(-1.), costheta_max_(1.), phi_min_(0.), phi_max_(2.*pi)
 SingleParticleGenerator::~SingleParticleGenerator()
 {
   delete msg_;
+  delete biasing_;
 }
 
 
@@ -115,11 +119,24 @@ void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
   bool fixed_momentum = momentum_ != G4ThreeVector{};
   bool restrict_angle = costheta_min_ != -1. || costheta_max_ != 1. || phi_min_ != 0. || phi_max_ !=2.*pi;
 
+  // The biased direction depends on the position of the vertex, which
+  // is then generated first. Otherwise it is generated after the
+  // direction, so that the random sequence of unbiased jobs is kept.
+  G4bool biased = !fixed_momentum && !restrict_angle && biasing_->IsEnabled();
+
+  G4ThreeVector position;
+  if (biased) position = geom_->GenerateVertex(region_);
+
+  // Statistical weight of the event, if the emission is biased
+  G4double weight = 1.;
+
   G4ThreeVector p_dir; // it will be set in the if branches below
   if (fixed_momentum) { // if the user provides a momentum direction
     p_dir = momentum_.unit();
   } else if (restrict_angle) { // if the user provides a range of angles
     p_dir = RandomDirectionInRange(costheta_min_, costheta_max_, phi_min_, phi_max_);
+  } else if (biased) {
+    p_dir = biasing_->SampleDirection(position, weight);
   } else {
     p_dir = G4RandomDirection();
   }
@@ -136,13 +153,14 @@ void SingleParticleGenerator::GeneratePrimaryVertex(G4Event* event)
   }
 
   // Generate an initial position for the particle using the geometry
-  G4ThreeVector position = geom_->GenerateVertex(region_);
+  if (!biased) position = geom_->GenerateVertex(region_);
 
   // Particle generated at start-of-event
   G4double time = 0.;
 
   // Create a new vertex
   G4PrimaryVertex* vertex = new G4PrimaryVertex(position, time);
+  vertex->SetWeight(weight);
 
     // Add particle to the vertex and this to the event
   vertex->SetPrimary(particle);
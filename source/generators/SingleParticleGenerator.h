@@ -24,6 +24,7 @@ class G4ParticleDefinition;
 namespace nexus {
 
   class GeometryBase;
+  class AngularBiasing;
 
   class SingleParticleGenerator: public G4VPrimaryGenerator
   {
@@ -65,6 +66,7 @@ namespace nexus {
     G4double phi_min_;
     G4double phi_max_;
 
+    AngularBiasing* biasing_; ///< Biasing of isotropic emission
 
   };
 
@@ -307,6 +307,21 @@ void decay0::initSpectrum() {
 	   fOut << " " << i << " " << spthe1_[i] << std::endl;
    fOut.close();
 
+   // Alias table of the bins of the spectrum, weighted by the part of
+   // each bin within the allowed energy range, so that the energy of the
+   // first particle is sampled directly instead of by acceptance/rejection.
+   // Bin i is sampled in [(i+1), (i+2)) keV, as in the original code.
+   // Modes with fixed energies don't use it (null spectrum).
+   if (spmax_ > 0.) {
+     const double eLow = (modebb_ != 10) ? 0. : ebb1_;
+     std::vector<double> weights(spthe1_.size());
+     for (size_t i=0; i != spthe1_.size(); i++) {
+       const double width = std::min(ebb2_, (i+2)/1000.) - std::max(eLow, (i+1)/1000.);
+       weights[i] = std::max(0., spthe1_[i]) * std::max(0., width);
+     }
+     spthe1Sampler_.SetWeights(weights);
+   }
+
    toallevents_=1.;
 	// Using
 	// http://cernlib.sourcearchive.com/documentation/2006.dfsg.2/rgmlt64_8F_source.html
@@ -446,20 +461,17 @@ void decay0::decay0DoItbb(std::vector<decay0Part> &outPart) const {
     return;
   }
 
-// sampling the energies: first e-/e+ Acceptance/rejection method (Von Neumann), as far as I can tell.
+// sampling the energies: first e-/e+. The original code uses the acceptance/rejection method
+// (Von Neumann) on the tabulated spectrum; we select its bin with an alias table, which gives
+// the same distribution, and sample the energy uniformly within the bin.
   double e2=0.;
-  int numThrow = 0;
 //  std::cerr << " ebb1 " << ebb1_  <<  " ebb2 " << ebb2_ << std::endl;
-  while(true) {
-     if (modebb_ != 10) e1_ = ebb2_*G4UniformRand();
-     else e1_ = ebb1_ + (ebb2_ - ebb1_)*G4UniformRand();
-//     if ((e0_ - e1_) < 0.) continue; //not needed if energy range are set properly.
-     const size_t k = static_cast<size_t>(static_cast<int>(e1_*1000.) - 1);
-     if (k >= spthe1_.size()) continue;
-     if(spmax_*G4UniformRand() < spthe1_[k]) break;
-     numThrow++;
-     if (numThrow%1000 == 0) std::cerr << " Thrwing e1 ... " << numThrow
-                                       << " times ... " << std::endl;
+  {
+     const double eLow = (modebb_ != 10) ? 0. : ebb1_;
+     const size_t k = spthe1Sampler_.Sample();
+     const double e1Min = std::max(eLow, (k+1)/1000.);
+     const double e1Max = std::min(ebb2_, (k+2)/1000.);
+     e1_ = e1Min + (e1Max - e1Min)*G4UniformRand();
   }
 //  second e-/e+ or X-ray
    if    ((modebb_ == 1) || (modebb_ == 2) || (modebb_ == 3 ) ||
@@ -16,6 +16,8 @@
 #include <string>
 #include <gsl/gsl_integration.h>
 
+#include "RandomUtils.h"
+
 struct decay0Part {
   int pdgCode_;
   double pmom_[3];
@@ -74,6 +76,7 @@ class decay0 {
     double levelE_;
     std::vector<double> spthe1_;
     double spmax_;
+    nexus::AliasSampler spthe1Sampler_; // Selects the 1 keV bin of the energy of the first particle
     float dataMasses_[4]; // only four, we don't simulate muons, hadrons, etc here.
     double toallevents_; // Normalization of the total decay probability:
 //         toallevents         - coefficient to calculate the corresponding
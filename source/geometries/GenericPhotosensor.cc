@@ -11,6 +11,7 @@
 #include "MaterialsList.h"
 #include "PmtSD.h"
 #include "OpticalMaterialProperties.h"
+#include "PhotonThinning.h"
 #include "Visibilities.h"
 
 #include <G4Box.hh>
@@ -173,6 +174,7 @@ void GenericPhotosensor::Construct()
 
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0., sensarea_zpos), sensarea_logic_vol,
                     name, case_logic_vol, false, 0, false);
+  sensarea_pos_ = G4ThreeVector(0., 0., sensarea_zpos);
 
 
   // WLS_COATING /////////////////////////////////////////////
@@ -219,6 +221,7 @@ void GenericPhotosensor::Construct()
   if (!sensitive_mpt_)
     G4Exception("[GenericPhotosensor]", "Construct()", FatalException,
                 "Sensor Optical Properties must be set before constructing");
+  PhotonThinning::ScaleEfficiency(sensitive_mpt_, name);
   G4OpticalSurface* sensitive_opsurf =
     new G4OpticalSurface(name + "_optSurf", unified, polished, dielectric_metal);
   sensitive_opsurf->SetMaterialPropertiesTable(sensitive_mpt_);
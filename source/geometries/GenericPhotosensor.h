@@ -42,6 +42,9 @@ namespace nexus {
     G4double GetThickness()   const;
     const G4String& GetName() const;
 
+    // Position of the sensitive area centre in the sensor reference frame
+    G4ThreeVector GetSensareaPosition() const;
+
     void SetVisibility           (G4bool visibility);
     void SetWithWLSCoating       (G4bool with_wls_coating);
     void SetWindowRefractiveIndex(G4MaterialPropertyVector* rindex);
@@ -62,6 +65,7 @@ namespace nexus {
     G4double window_thickness_;
     G4double sensarea_thickness_;
     G4double wls_thickness_;
+    G4ThreeVector sensarea_pos_;
     G4double reduced_width_, reduced_height_;
 
     G4Material* case_mat_;
@@ -87,6 +91,9 @@ namespace nexus {
   inline G4double GenericPhotosensor::GetThickness()   const { return thickness_; }
   inline const G4String& GenericPhotosensor::GetName() const { return name_; }
 
+  inline G4ThreeVector GenericPhotosensor::GetSensareaPosition() const
+  { return sensarea_pos_; }
+
   inline void GenericPhotosensor::SetVisibility(G4bool visibility)
   { visibility_ = visibility; }
 
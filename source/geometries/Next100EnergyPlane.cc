@@ -11,6 +11,7 @@
 #include "OpticalMaterialProperties.h"
 #include "Visibilities.h"
 #include "CylinderPointSampler2020.h"
+#include "SensorRegistry.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4PVPlacement.hh>
@@ -368,11 +369,15 @@ namespace nexus {
     /// Placing the encapsulating volume with all internal components in place ///
     vacuum_posz_ =
       copper_plate_posz_ - copper_plate_thickn_/2  + hole_length_front_/2.;
+    G4ThreeVector photocathode_pos =
+      (*pmt_rot_) * pmt_->GetPhotocathodePosition() + pmt_pos;
     G4ThreeVector pos;
     for (int i=0; i<num_PMTs_; i++) {
       pos = pmt_positions_[i];
       pos.setZ(vacuum_posz_);
       new G4PVPlacement(0, pos, vacuum_logic, "HOLE", mother_logic_, false, i, false);
+      SensorRegistry::Register(i, "PmtR11410", pos + photocathode_pos,
+                               pmt_->GetTimeBinning(), mother_logic_);
     }
 
 
@@ -12,6 +12,7 @@
 #include "IonizationSD.h"
 #include "OpticalMaterialProperties.h"
 #include "UniformElectricDriftField.h"
+#include "RadiusDependentDriftField.h"
 #include "XenonGasProperties.h"
 #include "CylinderPointSampler2020.h"
 
@@ -74,7 +75,8 @@ Next100FieldCage::Next100FieldCage():
   // EL gap generation disk parameters
   el_gap_gen_disk_diam_(0.),
   el_gap_gen_disk_x_(0.), el_gap_gen_disk_y_(0.),
-  el_gap_gen_disk_zmin_(0.), el_gap_gen_disk_zmax_(1.)
+  el_gap_gen_disk_zmin_(0.), el_gap_gen_disk_zmax_(1.),
+  drift_table_(""), drift_field_map_("")
 {
   /// Define new categories
   new G4UnitDefinition("kilovolt/cm","kV/cm","Electric field", kilovolt/cm);
@@ -168,6 +170,11 @@ Next100FieldCage::Next100FieldCage():
                           "Maximum Z range of the EL gap vertex generation disk.");
   el_gap_gen_disk_zmax_cmd.SetParameterName("el_gap_gen_disk_zmax", false);
   el_gap_gen_disk_zmax_cmd.SetRange("el_gap_gen_disk_zmax>=0.0 && el_gap_gen_disk_zmax<=1.0");
+
+  msg_->DeclareProperty("drift_table", drift_table_,
+                        "Drift table of a non-uniform drift field (computed from the field map if missing).");
+  msg_->DeclareProperty("drift_field_map", drift_field_map_,
+                        "(r,z) field map used to compute the drift table.");
 }
 
 
@@ -271,15 +278,27 @@ void Next100FieldCage::BuildActive()
   G4SDManager::GetSDMpointer()->AddNewDetector(ionisd);
 
   /// Define a drift field for this volume
-  UniformElectricDriftField* field = new UniformElectricDriftField();
   G4double global_active_zpos = active_zpos_ - GetELzCoord();
-  field->SetCathodePosition(global_active_zpos + active_length_/2.);
-  field->SetAnodePosition(global_active_zpos - active_length_/2.);
-  field->SetDriftVelocity(1. * mm/microsecond);
-  field->SetTransverseDiffusion(drift_transv_diff_);
-  field->SetLongitudinalDiffusion(drift_long_diff_);
   G4Region* drift_region = new G4Region("DRIFT");
-  drift_region->SetUserInformation(field);
+  if (drift_table_ != "") {
+    RadiusDependentDriftField* field =
+      new RadiusDependentDriftField(global_active_zpos - active_length_/2.,
+                                    global_active_zpos + active_length_/2.,
+                                    active_diam_/2.);
+    field->SetDriftVelocity(1. * mm/microsecond);
+    field->SetTransverseDiffusion(drift_transv_diff_);
+    field->SetLongitudinalDiffusion(drift_long_diff_);
+    field->LoadDriftTable(drift_table_, drift_field_map_);
+    drift_region->SetUserInformation(field);
+  } else {
+    UniformElectricDriftField* field = new UniformElectricDriftField();
+    field->SetCathodePosition(global_active_zpos + active_length_/2.);
+    field->SetAnodePosition(global_active_zpos - active_length_/2.);
+    field->SetDriftVelocity(1. * mm/microsecond);
+    field->SetTransverseDiffusion(drift_transv_diff_);
+    field->SetLongitudinalDiffusion(drift_long_diff_);
+    drift_region->SetUserInformation(field);
+  }
   drift_region->AddRootLogicalVolume(active_logic);
 
 
@@ -112,6 +112,10 @@ namespace nexus {
     G4double el_gap_gen_disk_diam_;
     G4double el_gap_gen_disk_x_, el_gap_gen_disk_y_;
     G4double el_gap_gen_disk_zmin_, el_gap_gen_disk_zmax_;
+
+    // Non-uniform drift field description
+    G4String drift_table_;     ///< Binary drift table (computed if missing)
+    G4String drift_field_map_; ///< (r,z) field map used to compute the table
   };
 
 } //end namespace nexus
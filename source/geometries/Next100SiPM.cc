@@ -11,6 +11,7 @@
 
 #include "MaterialsList.h"
 #include "OpticalMaterialProperties.h"
+#include "PhotonThinning.h"
 #include "Visibilities.h"
 #include "PmtSD.h"
 
@@ -177,6 +178,7 @@ void Next100SiPM::Construct()
   G4MaterialPropertiesTable* sipm_mt = new G4MaterialPropertiesTable();
   sipm_mt->AddProperty("EFFICIENCY", energies, efficiency, entries);
   sipm_mt->AddProperty("REFLECTIVITY", energies, reflectivity, entries);
+  PhotonThinning::ScaleEfficiency(sipm_mt, "Next100SiPM");
   G4OpticalSurface* sipm_opsurf =
     new G4OpticalSurface("SIPM_OPSURF", unified, polished, dielectric_metal);
   sipm_opsurf->SetMaterialPropertiesTable(sipm_mt);
@@ -15,12 +15,14 @@
 #include "OpticalMaterialProperties.h"
 #include "BoxPointSampler.h"
 #include "Visibilities.h"
+#include "PositionParameterisation.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4Box.hh>
 #include <G4Tubs.hh>
 #include <G4LogicalVolume.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVParameterised.hh>
 #include <G4Material.hh>
 #include <G4NistManager.hh>
 #include <G4OpticalSurface.hh>
@@ -178,6 +180,24 @@ void Next100SiPMBoard::Construct()
 
   // (Placement of this volume below.)
 
+  // The holes are placed in a teflon layer below the WLS coating, since
+  // a parameterised volume must be the only daughter of its mother.
+
+  G4String mask_body_name = "SIPM_BOARD_MASK_BODY";
+
+  G4Box* mask_body_solid_vol =
+    new G4Box(mask_body_name, size_/2., size_/2., mask_hole_length/2.);
+
+  G4LogicalVolume* mask_body_logic_vol =
+    new G4LogicalVolume(mask_body_solid_vol,
+                        mask_logic_vol->GetMaterial(), mask_body_name);
+
+  new G4PVPlacement(nullptr, G4ThreeVector(0., 0., mask_hole_zpos),
+                    mask_body_logic_vol, mask_body_name, mask_logic_vol,
+                    false, 0, false);
+
+  new G4LogicalSkinSurface(mask_body_name+"_OPSURF", mask_body_logic_vol, mask_opsurf);
+
   // SILICON PHOTOMULTIPLIER (SIPM) //////////////////////////////////
 
   // We use for now the generic photosensor until the exact features
@@ -194,7 +214,7 @@ void Next100SiPMBoard::Construct()
   sipm_->SetWithWLSCoating(true);
   sipm_->SetTimeBinning(time_binning_);
   sipm_->SetSensorDepth(2);
-  sipm_->SetMotherDepth(4);
+  sipm_->SetMotherDepth(5);
   sipm_->SetNamingOrder(1000);
   sipm_->Construct();
 
@@ -207,11 +227,17 @@ void Next100SiPMBoard::Construct()
 
   ////////////////////////////////////////////////////////////////////
 
-  // Placing now 8x8 replicas of the gas hole and SiPM
+  // Placing now 8x8 copies of the gas hole and SiPM. They are parameterised
+  // volumes, with copy numbers (i.e., SiPM numbers) running along y first.
 
   G4double zpos = board_thickness_ + sipm_->GetThickness()/2.;
 
-  G4int counter = 0;
+  // Depth of the sensitive area of the SiPMs in the board, following the
+  // placements of the mask, its body, the holes and the SiPM within them
+  G4double sensor_zpos = mask_zpos + mask_hole_zpos + sipm_zpos +
+                         sipm_->GetSensareaPosition().z();
+
+  std::vector<G4ThreeVector> hole_positions;
 
   for (auto i=0; i<8; i++) {
 
@@ -223,20 +249,25 @@ void Next100SiPMBoard::Construct()
 
       G4ThreeVector sipm_position(xpos, ypos, zpos);
       sipm_positions_.push_back(sipm_position);
+      sensor_positions_.push_back(G4ThreeVector(xpos, ypos, sensor_zpos));
 
-      // Placement of the WLS gas hole
-      new G4PVPlacement(nullptr, G4ThreeVector(xpos, ypos, 0.),
-                        mask_wls_hole_logic_vol, mask_wls_hole_name, mask_wls_logic_vol,
-                        false, counter, false);
-      // Placement of the hole+SiPM
-      new G4PVPlacement(nullptr, G4ThreeVector(xpos, ypos, mask_hole_zpos),
-                        mask_hole_logic_vol, mask_hole_name, mask_logic_vol,
-                        false, counter, false);
-
-      counter++;
+      hole_positions.push_back(G4ThreeVector(xpos, ypos, 0.));
     }
   }
 
+  // WLS gas holes
+  PositionParameterisation* hole_param =
+    new PositionParameterisation(hole_positions);
+
+  new G4PVParameterised(mask_wls_hole_name, mask_wls_hole_logic_vol,
+                        mask_wls_logic_vol, kUndefined,
+                        hole_param->GetNumberOfCopies(), hole_param);
+
+  // Holes with the SiPMs
+  new G4PVParameterised(mask_hole_name, mask_hole_logic_vol,
+                        mask_body_logic_vol, kUndefined,
+                        hole_param->GetNumberOfCopies(), hole_param);
+
   // VERTEX GENERATOR ////////////////////////////////////////////////
 
   vtxgen_ = new BoxPointSampler(size_, size_, board_thickness_, 0.,
@@ -248,10 +279,12 @@ void Next100SiPMBoard::Construct()
     G4VisAttributes light_blue = LightBlue();
     board_logic_vol ->SetVisAttributes(blue);
     mask_logic_vol  ->SetVisAttributes(light_blue);
+    mask_body_logic_vol->SetVisAttributes(light_blue);
   }
   else{
     board_logic_vol ->SetVisAttributes(G4VisAttributes::Invisible);
     mask_logic_vol  ->SetVisAttributes(G4VisAttributes::Invisible);
+    mask_body_logic_vol->SetVisAttributes(G4VisAttributes::Invisible);
   }
   mask_hole_logic_vol    ->SetVisAttributes(G4VisAttributes::Invisible);
   mask_wls_logic_vol     ->SetVisAttributes(G4VisAttributes::Invisible);
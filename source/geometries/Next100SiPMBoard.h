@@ -41,8 +41,11 @@ namespace nexus {
 
     G4double GetSize() const;
     G4double GetThickness() const;
+    G4double GetTimeBinning() const;
 
     const std::vector<G4ThreeVector>& GetSiPMPositions() const;
+    // Positions of the SiPM sensitive areas in the board reference frame
+    const std::vector<G4ThreeVector>& GetSensorPositions() const;
 
   private:
     G4GenericMessenger* msg_;
@@ -51,6 +54,7 @@ namespace nexus {
     G4double board_thickness_, mask_thickness_;
     G4double time_binning_;
     std::vector<G4ThreeVector> sipm_positions_;
+    std::vector<G4ThreeVector> sensor_positions_;
     G4bool   visibility_, sipm_visibility_;
     G4VPhysicalVolume*  mpv_;
     BoxPointSampler*    vtxgen_;
@@ -66,9 +70,15 @@ namespace nexus {
   inline G4double Next100SiPMBoard::GetThickness() const
   { return (board_thickness_ + mask_thickness_); }
 
+  inline G4double Next100SiPMBoard::GetTimeBinning() const
+  { return time_binning_; }
+
   inline const std::vector<G4ThreeVector>& Next100SiPMBoard::GetSiPMPositions() const
   { return sipm_positions_; }
 
+  inline const std::vector<G4ThreeVector>& Next100SiPMBoard::GetSensorPositions() const
+  { return sensor_positions_; }
+
 } // namespace nexus
 
 #endif
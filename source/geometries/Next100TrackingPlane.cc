@@ -11,6 +11,7 @@
 #include "Next100SiPMBoard.h"
 #include "CylinderPointSampler2020.h"
 #include "Visibilities.h"
+#include "SensorRegistry.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4Tubs.hh>
@@ -140,27 +141,27 @@ void Next100TrackingPlane::PlaceSiPMBoardColumns(G4int num_boards,
 
   G4double xpos = distance_from_center * size;
 
+  const std::vector<G4ThreeVector>& sensor_positions =
+    sipm_board_geom_->GetSensorPositions();
+
   for (auto i=0; i<num_boards; i++) {
     G4double ypos = (- 0.5 * (num_boards - 1) + i ) * size;
     G4ThreeVector position(xpos, ypos, zpos); board_pos_.push_back(position);
     new G4PVPlacement(nullptr, position,
                       logic_vol, logic_vol->GetName(), mpv_->GetLogicalVolume(),
                       false, board_index, false);
-    board_index++;
-  }
-}
-
 
-void Next100TrackingPlane::PrintSiPMPositions() const
-{
-  auto sipm_positions = sipm_board_geom_->GetSiPMPositions();
-
-  for (unsigned int i=0; i<board_pos_.size(); ++i) {
-    for (unsigned int j=0; j<sipm_positions.size(); ++j) {
-      G4int id = 1000 * (i+1) + j;
-      G4ThreeVector pos = sipm_positions[j] + board_pos_[i];
-      G4cout << "SiPM " << id << "  " << pos << G4endl;
+    // Register the SiPMs of the board, following the naming scheme
+    // set in Next100SiPMBoard (1000 * board + sipm), at the position
+    // of their sensitive area, as the sensitive detector does
+    for (unsigned int j=0; j<sensor_positions.size(); ++j) {
+      SensorRegistry::Register(1000 * board_index + j, "SiPM",
+                               position + sensor_positions[j],
+                               sipm_board_geom_->GetTimeBinning(),
+                               mpv_->GetLogicalVolume());
     }
+
+    board_index++;
   }
 }
 
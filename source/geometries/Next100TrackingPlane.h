@@ -37,8 +37,6 @@ namespace nexus {
     //
     G4ThreeVector GenerateVertex(const G4String&) const override;
 
-    void PrintSiPMPositions() const;
-
   private:
     void PlaceSiPMBoardColumns(G4int, G4double, G4double, G4int&, G4LogicalVolume*);
 
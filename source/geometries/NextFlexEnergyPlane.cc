@@ -16,6 +16,7 @@
 #include "UniformElectricDriftField.h"
 #include "CylinderPointSampler2020.h"
 #include "Visibilities.h"
+#include "SensorRegistry.h"
 
 #include <G4UnitsTable.hh>
 #include <G4GenericMessenger.hh>
@@ -426,12 +427,17 @@ void NextFlexEnergyPlane::BuildPMTs()
 
   /// Placing the encapsulating volumes ///
   G4double hole_posZ = pmt_iniZ_ + pmt_hole_length/2.;
+  G4ThreeVector photocathode_pos =
+    (*pmt_rot) * pmt_->GetPhotocathodePosition() + G4ThreeVector(0., 0., pmt_posz);
   G4ThreeVector pmt_hole_pos;
   for (int pmt_id=0; pmt_id < num_pmts_; pmt_id++) {
     pmt_hole_pos = pmt_positions_[pmt_id];
     pmt_hole_pos.setZ(hole_posZ);
     new G4PVPlacement(nullptr, pmt_hole_pos, pmt_hole_logic, pmt_hole_name,
                       mother_logic_, false, first_sensor_id_ + pmt_id, false);
+    SensorRegistry::Register(first_sensor_id_ + pmt_id, "PmtR11410",
+                             pmt_hole_pos + photocathode_pos,
+                             pmt_->GetTimeBinning(), mother_logic_);
   }
 
 
@@ -10,11 +10,13 @@
 
 #include "MaterialsList.h"
 #include "OpticalMaterialProperties.h"
+#include "PhotonThinning.h"
 #include "XenonGasProperties.h"
 #include "IonizationSD.h"
 #include "UniformElectricDriftField.h"
 #include "CylinderPointSampler2020.h"
 #include "GenericPhotosensor.h"
+#include "FiberTransport.h"
 #include "PmtSD.h"
 #include "Visibilities.h"
 
@@ -33,6 +35,7 @@
 #include <G4LogicalBorderSurface.hh>
 #include <G4UserLimits.hh>
 #include <G4Transform3D.hh>
+#include <G4Region.hh>
 
 
 using namespace nexus;
@@ -61,6 +64,7 @@ NextFlexFieldCage::NextFlexFieldCage():
   gate_transparency_       (0.95),               // Gate transparency
   photoe_prob_             (0),                  // OpticalPhotoElectric Probability
   fiber_claddings_         (2),                  // Number of fiber claddings (0, 1 or 2)
+  fiber_fast_transport_    (false),              // Fast simulation of the light transport in fibers
   fiber_sensor_binning_    (100. * ns),          // Size of fiber sensors time binning
   wls_mat_name_            ("TPB"),              // UV wls material name
   fiber_mat_name_          ("EJ280"),            // Fiber core material name
@@ -219,6 +223,9 @@ void NextFlexFieldCage::DefineConfigurationParameters()
   fiber_claddings_cmd.SetParameterName("fiber_claddings", false);
   fiber_claddings_cmd.SetRange("fiber_claddings>=0 && fiber_claddings<=2");
 
+  msg_->DeclareProperty("fiber_fast_transport", fiber_fast_transport_,
+                        "Parametrise the light transport along the fibers.");
+
   G4GenericMessenger::Command& fiber_sensor_binning_cmd =
     msg_->DeclareProperty("fiber_sensor_time_binning", fiber_sensor_binning_,
                           "Time bin size of fiber sensors.");
@@ -287,8 +294,11 @@ void NextFlexFieldCage::DefineMaterials()
   gas_temperature_ = xenon_gas_->GetTemperature();
   gas_e_lifetime_  = xenon_gas_->GetMaterialPropertiesTable()
                                ->GetConstProperty("ATTACHMENT");
+  // The yield of the gas is scaled by the photon thinning, which
+  // FakeGrid applies again, so the meshes are given the real one
   gas_sc_yield_    = xenon_gas_->GetMaterialPropertiesTable()
-                               ->GetConstProperty("SCINTILLATIONYIELD");
+                               ->GetConstProperty("SCINTILLATIONYIELD") /
+                     PhotonThinning::GetSurvivalFactor();
 
   // Teflon
   teflon_mat_ = G4NistManager::Instance()->FindOrBuildMaterial("G4_TEFLON");
@@ -830,6 +840,14 @@ void NextFlexFieldCage::BuildFibers()
   // Updating info
   if (fiber_claddings_ == 0) out_logic_volume = core_logic;
 
+  // Fast simulation of the light transport along the fibers:
+  // photons trapped in the core are moved directly to its ends
+  if (fiber_fast_transport_) {
+    G4Region* fiber_region = new G4Region("FIBER_CORE");
+    fiber_region->AddRootLogicalVolume(core_logic);
+    new FiberTransport(fiber_region, inn_logic_volume->GetMaterial());
+  }
+
   // Vertex generator
   fiber_gen_ = new CylinderPointSampler2020(inner_rad, outer_rad, fiber_length/2., 0., twopi, nullptr,
                                             G4ThreeVector(0., 0., fiber_iniZ_ + fiber_length/2.));
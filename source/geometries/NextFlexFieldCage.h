@@ -140,6 +140,7 @@ namespace nexus {
     G4double fiber_iniZ_;
     G4double fiber_finZ_;
     G4int    num_fibers_;
+    G4bool   fiber_fast_transport_;
 
     // FIBER SENSORS
     GenericPhotosensor* left_sensor_;
@@ -17,6 +17,8 @@
 #include "GenericPhotosensor.h"
 #include "PmtSD.h"
 #include "Visibilities.h"
+#include "SensorRegistry.h"
+#include "PositionParameterisation.h"
 
 #include <G4UnitsTable.hh>
 #include <G4GenericMessenger.hh>
@@ -31,6 +33,7 @@
 #include <G4SDManager.hh>
 #include <G4VisAttributes.hh>
 #include <G4PVPlacement.hh>
+#include <G4PVParameterised.hh>
 #include <G4OpticalSurface.hh>
 #include <G4LogicalSkinSurface.hh>
 #include <G4LogicalBorderSurface.hh>
@@ -367,23 +370,52 @@ void NextFlexTrackingPlane::BuildTeflon()
   new G4PVPlacement(0, G4ThreeVector(0., 0., SiPM_pos_z), SiPM_logic,
                     SiPM_logic->GetName(), hole_logic, false, 0, verbosity_);
 
+  // The teflon holes are placed in a teflon layer below the WLS, since
+  // a parameterised volume must be the only daughter of its mother.
+  // Its copy number is the first sensor ID, which is added to the hole
+  // copy number to give the SiPM ID (see BuildSiPM).
+  G4String body_name = "TP_TEFLON_BODY";
+
+  G4Tubs* body_solid =
+    new G4Tubs(body_name, 0., diameter_/2., hole_length/2., 0, twopi);
+
+  G4LogicalVolume* body_logic =
+    new G4LogicalVolume(body_solid, teflon_mat_, body_name);
+
+  new G4PVPlacement(nullptr, G4ThreeVector(0., 0., hole_posz), body_logic,
+                    body_name, teflon_logic, false, first_sensor_id_, verbosity_);
+
+  new G4LogicalSkinSurface(body_name, body_logic, teflon_optSurf);
+
   // Replicating the teflon & wls-teflon holes
+  std::vector<G4ThreeVector> hole_positions;
+
   for (G4int i=0; i<num_SiPMs_; i++) {
     G4int SiPM_id = first_sensor_id_ + i;
 
     G4ThreeVector hole_pos = SiPM_positions_[i];
-    hole_pos.setZ(hole_posz);
-    new G4PVPlacement(nullptr, hole_pos, hole_logic, hole_name,
-                      teflon_logic, true, SiPM_id, false);
+    hole_pos.setZ(0.);
+    hole_positions.push_back(hole_pos);
 
-    G4ThreeVector wls_hole_pos = SiPM_positions_[i];
-    new G4PVPlacement(nullptr, wls_hole_pos, wls_hole_logic, wls_hole_name,
-                      teflon_wls_logic, true, SiPM_id, false);
+    SensorRegistry::Register(SiPM_id, "TP_SiPM",
+                             G4ThreeVector(hole_pos.x(), hole_pos.y(),
+                                           teflon_posZ + hole_posz + SiPM_pos_z +
+                                           SiPM_->GetSensareaPosition().z()),
+                             SiPM_binning_, mother_logic_);
 
     if (sipm_verbosity_) G4cout << "* TP_SiPM " << SiPM_id << " position: "
                                 << hole_pos << G4endl;
   }
 
+  PositionParameterisation* hole_param =
+    new PositionParameterisation(hole_positions);
+
+  new G4PVParameterised(hole_name, hole_logic, body_logic, kUndefined,
+                        hole_param->GetNumberOfCopies(), hole_param);
+
+  new G4PVParameterised(wls_hole_name, wls_hole_logic, teflon_wls_logic, kUndefined,
+                        hole_param->GetNumberOfCopies(), hole_param);
+
   // Placing the overall teflon sub-system
   new G4PVPlacement(nullptr, G4ThreeVector(0., 0., teflon_posZ), teflon_logic,
                     teflon_name, mother_logic_, false, 0, verbosity_);
@@ -399,10 +431,12 @@ void NextFlexTrackingPlane::BuildTeflon()
   /// Visibilities ///
   if (visibility_) {
     teflon_logic->SetVisAttributes(nexus::LightBlue());
+    body_logic  ->SetVisAttributes(nexus::LightBlue());
     hole_logic  ->SetVisAttributes(nexus::LightBlue());
   }
   else {
     teflon_logic->SetVisAttributes(G4VisAttributes::Invisible);
+    body_logic  ->SetVisAttributes(G4VisAttributes::Invisible);
     hole_logic  ->SetVisAttributes(G4VisAttributes::Invisible);
   }
   teflon_wls_logic->SetVisAttributes(G4VisAttributes::Invisible);
@@ -429,9 +463,10 @@ G4LogicalVolume* NextFlexTrackingPlane::BuildSiPM()
   // Set time binning
   SiPM_->SetTimeBinning(SiPM_binning_);
 
-  // Set mother depth & naming order
-  SiPM_->SetSensorDepth(1);
-  SiPM_->SetMotherDepth(2);
+  // Set mother depth & naming order: the SiPM ID is the copy number
+  // of the hole plus the one of the teflon layer, i.e., the first ID.
+  SiPM_->SetSensorDepth(2);
+  SiPM_->SetMotherDepth(3);
   SiPM_->SetNamingOrder(1);
 
   // Set visibility
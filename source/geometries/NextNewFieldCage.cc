@@ -12,6 +12,7 @@
 #include "IonizationSD.h"
 #include "UniformElectricDriftField.h"
 #include "OpticalMaterialProperties.h"
+#include "PhotonThinning.h"
 #include "IonizationSD.h"
 #include "XenonGasProperties.h"
 #include "CylinderPointSampler.h"
@@ -273,7 +274,10 @@ namespace nexus {
     gas_         = mother_logic_->GetMaterial();
     pressure_    = gas_->GetPressure();
     temperature_ = gas_->GetTemperature();
-    sc_yield_    = gas_->GetMaterialPropertiesTable()->GetConstProperty("SCINTILLATIONYIELD");
+    // The yield of the gas is scaled by the photon thinning, which
+    // FakeGrid applies again, so the meshes are given the real one
+    sc_yield_    = gas_->GetMaterialPropertiesTable()->GetConstProperty("SCINTILLATIONYIELD") /
+                   PhotonThinning::GetSurvivalFactor();
     e_lifetime_  = gas_->GetMaterialPropertiesTable()->GetConstProperty("ATTACHMENT");
 
     // High density polyethylene for the field cage
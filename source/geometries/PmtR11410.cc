@@ -9,6 +9,7 @@
 #include "PmtR11410.h"
 #include "MaterialsList.h"
 #include "OpticalMaterialProperties.h"
+#include "PhotonThinning.h"
 #include "PmtSD.h"
 #include "CylinderPointSampler.h"
 #include "Visibilities.h"
@@ -143,6 +144,7 @@ namespace nexus {
     G4double photocathode_posz = window_posz - window_thickness_/2. - photocathode_thickness_/2.;
     new G4PVPlacement(0, G4ThreeVector(0., 0., photocathode_posz), photocathode_logic,
 		      "PMT_PHOTOCATHODE", pmt_gas_logic, false, 0);
+    photocathode_pos_ = G4ThreeVector(0., 0., pmt_gas_posz + photocathode_posz);
 
     // Optical properties
     G4OpticalSurface* pmt_opt_surf = GetPhotOptSurf();
@@ -382,6 +384,7 @@ namespace nexus {
     G4MaterialPropertiesTable* phcath_mpt = new G4MaterialPropertiesTable();
     phcath_mpt->AddProperty("EFFICIENCY", ENERGIES, EFFICIENCY, entries);
     phcath_mpt->AddProperty("REFLECTIVITY", ENERGIES, REFLECTIVITY, entries);
+    PhotonThinning::ScaleEfficiency(phcath_mpt, "PmtR11410");
 
     G4OpticalSurface* opt_surf =
       new G4OpticalSurface("PHOTOCATHODE", unified, polished, dielectric_metal);
@@ -33,6 +33,12 @@ namespace nexus {
 
     G4ThreeVector GetRelPosition();
 
+    // Position of the photocathode centre in the PMT reference frame
+    G4ThreeVector GetPhotocathodePosition() const;
+
+    // Time binning of the sensitive detector
+    G4double GetTimeBinning() const;
+
     // Generate a vertex within a given region of the geometry
     G4ThreeVector GenerateVertex(const G4String& region) const;
 
@@ -52,6 +58,7 @@ namespace nexus {
     G4double body_thickness_;
     G4double window_diam_, window_thickness_;
     G4double photocathode_diam_, photocathode_thickness_;
+    G4ThreeVector photocathode_pos_;
 
     // Vertex generators
     CylinderPointSampler* front_body_gen_;
@@ -76,6 +83,12 @@ namespace nexus {
   inline void PmtR11410::SetSensorDepth(G4int sensor_depth)
   { sd_depth_ = sensor_depth; }
 
+  inline G4ThreeVector PmtR11410::GetPhotocathodePosition() const
+  { return photocathode_pos_; }
+
+  inline G4double PmtR11410::GetTimeBinning() const
+  { return binning_; }
+
 } // end namespace nexus
 
 #endif
@@ -10,6 +10,7 @@
 
 #include "PmtSD.h"
 #include "OpticalMaterialProperties.h"
+#include "PhotonThinning.h"
 #include "MaterialsList.h"
 #include "Visibilities.h"
 
@@ -159,6 +160,7 @@ namespace nexus {
     G4MaterialPropertiesTable* phcath_mpt = new G4MaterialPropertiesTable();
     phcath_mpt->AddProperty("EFFICIENCY", ENERGIES, EFFICIENCY, entries);
     phcath_mpt->AddProperty("REFLECTIVITY", ENERGIES, REFLECTIVITY, entries);
+    PhotonThinning::ScaleEfficiency(phcath_mpt, "PmtR7378A");
 
     G4OpticalSurface* phcath_opsur =
       new G4OpticalSurface("PHOTOCATHODE", unified, polished, dielectric_metal);
@@ -0,0 +1,37 @@
+// ----------------------------------------------------------------------------
+// nexus | PositionParameterisation.cc
+//
+// Parameterisation that places the copies of a volume at a list of
+// positions, without rotation. Copy number i is placed at position i,
+// so it can replace a loop of G4PVPlacements numbered 0 to N-1.
+// As any parameterised volume, it must be the only daughter of its mother.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PositionParameterisation.h"
+
+#include <G4VPhysicalVolume.hh>
+
+using namespace nexus;
+
+
+PositionParameterisation::PositionParameterisation(const std::vector<G4ThreeVector>& positions):
+  G4VPVParameterisation(), positions_(positions)
+{
+}
+
+
+
+PositionParameterisation::~PositionParameterisation()
+{
+}
+
+
+
+void PositionParameterisation::ComputeTransformation(const G4int copy_no,
+                                                     G4VPhysicalVolume* pv) const
+{
+  pv->SetTranslation(positions_[copy_no]);
+  pv->SetRotation(nullptr);
+}
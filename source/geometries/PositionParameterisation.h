@@ -0,0 +1,48 @@
+// ----------------------------------------------------------------------------
+// nexus | PositionParameterisation.h
+//
+// Parameterisation that places the copies of a volume at a list of
+// positions, without rotation. Copy number i is placed at position i,
+// so it can replace a loop of G4PVPlacements numbered 0 to N-1.
+// As any parameterised volume, it must be the only daughter of its mother.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef POSITION_PARAMETERISATION_H
+#define POSITION_PARAMETERISATION_H
+
+#include <G4VPVParameterisation.hh>
+#include <G4ThreeVector.hh>
+
+#include <vector>
+
+class G4VPhysicalVolume;
+
+
+namespace nexus {
+
+  class PositionParameterisation: public G4VPVParameterisation
+  {
+  public:
+    /// Constructor taking the positions of the copies
+    /// in the reference frame of the mother volume
+    PositionParameterisation(const std::vector<G4ThreeVector>& positions);
+    /// Destructor
+    ~PositionParameterisation();
+
+    void ComputeTransformation(const G4int copy_no, G4VPhysicalVolume*) const;
+
+    /// Number of copies to be passed to the G4PVParameterised
+    G4int GetNumberOfCopies() const;
+
+  private:
+    std::vector<G4ThreeVector> positions_;
+  };
+
+  inline G4int PositionParameterisation::GetNumberOfCopies() const
+  { return positions_.size(); }
+
+} // end namespace nexus
+
+#endif
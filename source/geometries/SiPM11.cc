@@ -10,6 +10,7 @@
 #include "PmtSD.h"
 #include "MaterialsList.h"
 #include "OpticalMaterialProperties.h"
+#include "PhotonThinning.h"
 #include "Visibilities.h"
 
 #include <G4Box.hh>
@@ -149,6 +150,7 @@ namespace nexus {
     G4MaterialPropertiesTable* sipm_mt = new G4MaterialPropertiesTable();
     sipm_mt->AddProperty("EFFICIENCY", energies, efficiency_red, entries);
     sipm_mt->AddProperty("REFLECTIVITY", energies, reflectivity, entries);
+    PhotonThinning::ScaleEfficiency(sipm_mt, "SiPM11");
 
     G4OpticalSurface* sipm_opsurf =
       new G4OpticalSurface("SIPM_OPSURF", unified, polished, dielectric_metal);
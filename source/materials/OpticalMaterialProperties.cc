@@ -10,6 +10,7 @@
 #include "XenonGasProperties.h"
 #include "XenonGasProperties.h"
 #include "SellmeierEquation.h"
+#include "PhotonThinning.h"
 
 #include <G4MaterialPropertiesTable.hh>
 
@@ -534,7 +535,7 @@ G4MaterialPropertiesTable* OpticalMaterialProperties::GAr(G4double sc_yield,
   mpt->AddProperty("ELSPECTRUM",    sc_energy, intensity, sc_entries);
 
   // CONST PROPERTIES
-  mpt->AddConstProperty("SCINTILLATIONYIELD", sc_yield);
+  mpt->AddConstProperty("SCINTILLATIONYIELD", sc_yield * PhotonThinning::GetSurvivalFactor());
   mpt->AddConstProperty("FASTTIMECONSTANT",   6.*ns);
   mpt->AddConstProperty("SLOWTIMECONSTANT",   37.*ns);
   mpt->AddConstProperty("YIELDRATIO",         .52);
@@ -549,7 +550,7 @@ G4MaterialPropertiesTable* OpticalMaterialProperties::GAr(G4double sc_yield,
 /// Gaseous Xenon ///
 G4MaterialPropertiesTable* OpticalMaterialProperties::GXe(G4double pressure,
                                                           G4double temperature,
-                                                          G4int    sc_yield,
+                                                          G4double sc_yield,
                                                           G4double e_lifetime)
 {
   XenonGasProperties GXe_prop(pressure, temperature);
@@ -596,7 +597,7 @@ G4MaterialPropertiesTable* OpticalMaterialProperties::GXe(G4double pressure,
   mpt->AddProperty("SLOWCOMPONENT", sc_energy, intensity, sc_entries);
 
   // CONST PROPERTIES
-  mpt->AddConstProperty("SCINTILLATIONYIELD", sc_yield);
+  mpt->AddConstProperty("SCINTILLATIONYIELD", sc_yield * PhotonThinning::GetSurvivalFactor());
   mpt->AddConstProperty("RESOLUTIONSCALE",    1.0);
   mpt->AddConstProperty("FASTTIMECONSTANT",   4.5  * ns);
   mpt->AddConstProperty("SLOWTIMECONSTANT",   100. * ns);
@@ -613,7 +614,7 @@ G4MaterialPropertiesTable* OpticalMaterialProperties::FakeGrid(G4double pressure
                                                                G4double temperature,
                                                                G4double transparency,
                                                                G4double thickness,
-                                                               G4int    sc_yield,
+                                                               G4double sc_yield,
                                                                G4double e_lifetime,
                                                                G4double photoe_p)
 {
@@ -53,14 +53,14 @@ namespace nexus {
 
     static G4MaterialPropertiesTable* GXe(G4double pressure=1.*bar,
                                           G4double temperature=STP_Temperature,
-                                          G4int sc_yield=25510/MeV,
+                                          G4double sc_yield=25510/MeV,
                                           G4double e_lifetime=1000.*ms);
 
     static G4MaterialPropertiesTable* FakeGrid(G4double pressure=1.*bar,
                                                G4double temperature=STP_Temperature,
                                                G4double transparency=.9,
                                                G4double thickness=1.*mm,
-                                               G4int sc_yield=25510/MeV,
+                                               G4double sc_yield=25510/MeV,
                                                G4double e_lifetime=1000.*ms,
                                                G4double photoe_p=0);
 
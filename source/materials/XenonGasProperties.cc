@@ -7,28 +7,29 @@
 // ----------------------------------------------------------------------------
 
 #include "XenonGasProperties.h"
-#include "Interpolation.h"
 
 #include <G4SystemOfUnits.hh>
 #include <G4PhysicalConstants.hh>
 #include <G4AnalyticalPolSolver.hh>
 #include <G4MaterialPropertiesTable.hh>
 
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+
 using namespace nexus;
 
 
 XenonGasProperties::XenonGasProperties(G4double pressure, G4double temperature):
-  pressure_(pressure),
-  //temperature_(temperature),
-  data_()
+  pressure_(pressure)
+  //temperature_(temperature)
 {
 }
 
 
 XenonGasProperties::XenonGasProperties():
-  pressure_(),
-  //temperature_(),
-  data_()
+  pressure_()
+  //temperature_()
 {
 }
 
@@ -236,9 +237,25 @@ G4double XenonGasProperties::ELLightYield(G4double field_strength) const
 
 void XenonGasProperties::MakeDataTable()
 {
-  // Fills the data_ vector with temperature, pressure, and density data
+  GetDensityTable();
+}
+
+
+const XenonGasProperties::DensityTable& XenonGasProperties::GetDensityTable()
+{
+  // The table is read the first time it is needed and kept
+  // for the rest of the process
+  static const DensityTable table = ReadDensityTable();
+  return table;
+}
+
+
+XenonGasProperties::DensityTable XenonGasProperties::ReadDensityTable()
+{
+  // Reads the temperature, pressure and density data.
   // Assumes the data file goes up in pressure then temperature
-  // with the format: Temperature Pressure Density
+  // with the format: Temperature Pressure Density,
+  // in a grid with constant steps
 
   // Open file
   G4String path(std::getenv("NEXUSDIR"));
@@ -250,38 +267,46 @@ void XenonGasProperties::MakeDataTable()
     throw "File could not be opened";
   }
 
-  std::vector<std::vector<G4double>> data;
+  std::vector<G4double> temps, pressures;
+  DensityTable table;
+
   // Read lines in file
   G4String thisline;
   getline(inFile, thisline); // don't use first line
-  G4int npressures = 0;
-  G4int ntemps = 0;
-  G4int count = 0;
-  G4double thistemp = 0;
   G4double temp, press, dens;
   char comma;
 
   while (inFile>>temp>>comma>>press>>comma>>dens){
-    std::vector<G4double> thisdata {temp*kelvin, press*bar, dens*(kg/m3)};
-    data_.push_back(thisdata);
-
     // Figure out how many temperature and pressures we have
-    if (temp == thistemp){
-      npressures++;
-    }
-    else {
-      thistemp = temp;
-      ntemps++;
-      npressures = 1;
-    }
-    count++;
+    if (temps.empty() || temp != temps.back()) temps.push_back(temp);
+    if (temps.size() == 1) pressures.push_back(press);
+    table.density.push_back(dens*(kg/m3));
   }
 
-  npressures_ = npressures-1;
-  ntemps_ = ntemps;
-
   inFile.close();
-  return;
+
+  table.ntemps     = temps.size();
+  table.npressures = pressures.size();
+
+  if (table.ntemps < 2 || table.npressures < 2 ||
+      table.density.size() != (size_t) table.ntemps * table.npressures) {
+    throw "Xenon density table is not a regular grid";
+  }
+
+  table.tmin  = temps.front() * kelvin;
+  table.tstep = (temps.back() - temps.front()) / (table.ntemps-1) * kelvin;
+  table.pmin  = pressures.front() * bar;
+  table.pstep = (pressures.back() - pressures.front()) / (table.npressures-1) * bar;
+
+  // Lookups rely on constant steps, so check it holds for the whole grid
+  for (G4int i=0; i<table.ntemps; ++i)
+    if (std::abs(temps[i]*kelvin - (table.tmin + i*table.tstep)) > 1.e-3*table.tstep)
+      throw "Xenon density table is not a regular grid";
+  for (G4int j=0; j<table.npressures; ++j)
+    if (std::abs(pressures[j]*bar - (table.pmin + j*table.pstep)) > 1.e-3*table.pstep)
+      throw "Xenon density table is not a regular grid";
+
+  return table;
 }
 
 
@@ -289,87 +314,28 @@ G4double XenonGasProperties::GetDensity(G4double pressure, G4double temperature)
 {
   // Interpolate to calculate the density
   // at a given pressure and temperature
-  G4double density = 5.324 * kg/m3;
-  MakeDataTable();
+  const DensityTable& table = GetDensityTable();
 
-  // Find correct interval and use bilinear interpolation
-  G4bool found = false;
-  G4int tcount = 0;
-  G4int pcount = 0;
-  G4int count = 0;
-  G4double t1, t2, p1, p2, d11, d12, d21, d22, d1, d2;
-
-  while (tcount < ntemps_-1) {
-    t1 = data_[count][0];
-    t2 = data_[count+npressures_][0];
-
-    if (temperature >= t1 && temperature < t2) {
-      while (pcount < npressures_-1) {
-        p1 = data_[count][1];
-        p2 = data_[count+1][1];
-
-        if (pressure >= p1 && pressure < p2) {
-          d11 = data_[count][2];
-          d12 = data_[count+1][2];
-          d21 = data_[count+npressures_][2];
-          d22 = data_[count+npressures_+1][2];
-
-          density = BilinearInterpolation(temperature, t1, t2,
-            pressure, p1, p2,
-            d11, d12, d21, d22);
-            found = true;
-            break;
-        }
-        pcount++;
-        count++;
-      }
-
-      if (!found) {
-        if (pressure == data_[count][1]) {
-          d1 = data_[count][2];
-          d2 = data_[count+npressures_][2];
-          density = LinearInterpolation(temperature, t1, t2, d1, d2);
-          found = true;
-        } else {
-          throw "Unknown xenon density for this pressure!";
-        }
-      }
+  G4double tpos = (temperature - table.tmin) / table.tstep;
+  G4double ppos = (pressure    - table.pmin) / table.pstep;
 
-      break;
-    }
-    tcount++;
-    pcount = 0;
-    count += npressures_;
+  if (!(tpos >= 0. && tpos <= table.ntemps-1)) {
+    throw "Unknown xenon density for this temperature";
   }
-
-  if (!found) {
-    if (temperature == data_[count][0]) {
-      while (pcount< npressures_-1) {
-        p1 = data_[count][1];
-        p2 = data_[count+1][1];
-
-        if (pressure >= p1 && pressure < p2){
-          d1 = data_[count][2];
-          d2 = data_[count+1][2];
-
-          density = LinearInterpolation(pressure, p1, p2, d1, d2);
-          found = true;
-          break;
-        }
-        pcount++;
-        count++;
-      }
-      if (!found) {
-        if (pressure == data_[count][1]) {
-          density = data_[count][2];
-          found = true;
-        } else {
-          throw "Unknown xenon density for this pressure!";
-        }
-      }
-    } else {
-        throw "Unknown xenon density for this temperature";
-    }
+  if (!(ppos >= 0. && ppos <= table.npressures-1)) {
+    throw "Unknown xenon density for this pressure!";
   }
-  return density;
+
+  // Find correct interval and use bilinear interpolation
+  G4int it = std::min(G4int(tpos), table.ntemps-2);
+  G4int ip = std::min(G4int(ppos), table.npressures-2);
+
+  G4double ft = tpos - it;
+  G4double fp = ppos - ip;
+
+  const G4double* d1 = &table.density[it * table.npressures + ip];
+  const G4double* d2 = d1 + table.npressures;
+
+  return (1.-ft) * ((1.-fp) * d1[0] + fp * d1[1]) +
+             ft  * ((1.-fp) * d2[0] + fp * d2[1]);
 }
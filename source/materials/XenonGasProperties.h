@@ -32,7 +32,10 @@ namespace nexus {
     G4double Scintillation(G4double energy);
     void Scintillation(G4int entries, G4double* energy, G4double* intensity);
 
+    /// Load the density table (only read from file once per process)
     void MakeDataTable();
+    /// Density for a given pressure and temperature, interpolated
+    /// from the NIST data table
     G4double GetDensity(G4double pressure, G4double temperature);
 
     static G4double Density(G4double pressure);
@@ -42,12 +45,21 @@ namespace nexus {
     G4double ELLightYield(G4double field_strength) const;
 
 
+  private:
+    /// Density values in a regular (temperature, pressure) grid
+    struct DensityTable {
+      G4int ntemps, npressures;
+      G4double tmin, tstep;
+      G4double pmin, pstep;
+      std::vector<G4double> density; // index: itemp * npressures + ipress
+    };
+
+    static const DensityTable& GetDensityTable();
+    static DensityTable ReadDensityTable();
+
   private:
     G4double pressure_;
     //G4double temperature_;
-    G4int npressures_;
-    G4int ntemps_;
-    std::vector<std::vector<G4double>> data_; // temp, press, density
 
   };
 
@@ -0,0 +1,413 @@
+// ----------------------------------------------------------------------------
+// nexus | nexus-bench.cc
+//
+// Performance benchmark of nexus. It runs a set of standard workloads
+// (pairs of init/config macros with fixed seeds, in macros/benchmarks)
+// and reports their throughput and time split as JSON, so that results
+// can be compared across versions.
+//
+// Each workload runs in a child process, since Geant4 allows only one
+// run manager per process. It must be run from the nexus directory.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "NexusApp.h"
+#include "SaveAllSteppingAction.h"
+
+#include <G4Event.hh>
+#include <G4Track.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4UserSteppingAction.hh>
+#include <G4UserTrackingAction.hh>
+#include <G4Version.hh>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <ctime>
+#include <iterator>
+
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace nexus;
+
+
+namespace {
+
+  struct Workload {
+    G4String name;
+    G4String init_macro;
+    G4int    nevents;
+  };
+
+  // Standard workloads. The number of events is chosen
+  // so that each of them takes of the order of a minute.
+  const Workload standard_workloads[] = {
+    {"NEXT100_Kr83m_optics", "macros/benchmarks/NEXT100_Kr83m_optics.init.mac",  20},
+    {"NEXT100_bb0nu",        "macros/benchmarks/NEXT100_bb0nu.init.mac",        200},
+    {"NEW_Bi214",            "macros/benchmarks/NEW_Bi214.init.mac",           2000},
+    {"NEXT100_muon",         "macros/benchmarks/NEXT100_muon.init.mac",          20},
+    {"NEXT100_S2_point",     "macros/benchmarks/NEXT100_S2_point.init.mac",      10}
+  };
+
+  typedef std::chrono::steady_clock Clock;
+
+  G4double Seconds(const Clock::duration& d)
+  {
+    return std::chrono::duration<G4double>(d).count();
+  }
+
+
+  /// Run manager recording the time spent in the generation,
+  /// tracking and persistency of each event
+  class BenchApp: public NexusApp
+  {
+  public:
+    BenchApp(G4String init_macro):
+      NexusApp(init_macro), event_time_(0.), generation_time_(0.),
+      persistency_time_(0.) {}
+
+    virtual G4Event* GenerateEvent(G4int i_event)
+    {
+      Clock::time_point start = Clock::now();
+      G4Event* event = NexusApp::GenerateEvent(i_event);
+      generation_time_ += Seconds(Clock::now() - start);
+      return event;
+    }
+
+    virtual void ProcessOneEvent(G4int i_event)
+    {
+      Clock::time_point start = Clock::now();
+      NexusApp::ProcessOneEvent(i_event);
+      event_time_ += Seconds(Clock::now() - start);
+    }
+
+    virtual void AnalyzeEvent(G4Event* event)
+    {
+      Clock::time_point start = Clock::now();
+      NexusApp::AnalyzeEvent(event);
+      persistency_time_ += Seconds(Clock::now() - start);
+    }
+
+    G4double GetGenerationTime() const { return generation_time_; }
+    G4double GetPersistencyTime() const { return persistency_time_; }
+    G4double GetTrackingTime() const
+    { return event_time_ - generation_time_ - persistency_time_; }
+
+  private:
+    G4double event_time_, generation_time_, persistency_time_;
+  };
+
+
+  /// Stepping action counting steps, forwarding to the workload's own action
+  class CountingSteppingAction: public G4UserSteppingAction
+  {
+  public:
+    CountingSteppingAction(G4UserSteppingAction* action):
+      action_(action), nsteps_(0) {}
+    ~CountingSteppingAction() { delete action_; }
+
+    virtual void SetSteppingManagerPointer(G4SteppingManager* sm)
+    {
+      G4UserSteppingAction::SetSteppingManagerPointer(sm);
+      if (action_) action_->SetSteppingManagerPointer(sm);
+    }
+
+    virtual void UserSteppingAction(const G4Step* step)
+    {
+      ++nsteps_;
+      if (action_) action_->UserSteppingAction(step);
+    }
+
+    G4long GetNumberOfSteps() const { return nsteps_; }
+
+  private:
+    G4UserSteppingAction* action_;
+    G4long nsteps_;
+  };
+
+
+  /// Tracking action counting optical photons, forwarding
+  /// to the workload's own action
+  class CountingTrackingAction: public G4UserTrackingAction
+  {
+  public:
+    CountingTrackingAction(G4UserTrackingAction* action):
+      action_(action), nphotons_(0) {}
+    ~CountingTrackingAction() { delete action_; }
+
+    virtual void SetTrackingManagerPointer(G4TrackingManager* tm)
+    {
+      G4UserTrackingAction::SetTrackingManagerPointer(tm);
+      if (action_) action_->SetTrackingManagerPointer(tm);
+    }
+
+    virtual void PreUserTrackingAction(const G4Track* track)
+    {
+      if (track->GetDefinition() == G4OpticalPhoton::Definition())
+        ++nphotons_;
+      if (action_) action_->PreUserTrackingAction(track);
+    }
+
+    virtual void PostUserTrackingAction(const G4Track* track)
+    {
+      if (action_) action_->PostUserTrackingAction(track);
+    }
+
+    G4long GetNumberOfPhotons() const { return nphotons_; }
+
+  private:
+    G4UserTrackingAction* action_;
+    G4long nphotons_;
+  };
+
+
+  G4String Rate(G4double n, G4double t)
+  {
+    if (n < 0. || t <= 0.) return "null";
+    std::ostringstream s;
+    s << n/t;
+    return s.str();
+  }
+
+
+  /// Run a workload in the current process and return its results as JSON
+  G4String RunWorkload(const Workload& wl)
+  {
+    Clock::time_point start = Clock::now();
+    BenchApp* app = new BenchApp(wl.init_macro);
+    app->Initialize();
+    G4double init_time = Seconds(Clock::now() - start);
+
+    // The persistency manager retrieves the SaveAllSteppingAction
+    // from the run manager, so it cannot be wrapped
+    CountingSteppingAction* stepping = 0;
+    G4UserSteppingAction* user_stepping =
+      const_cast<G4UserSteppingAction*>(app->GetUserSteppingAction());
+    if (!dynamic_cast<SaveAllSteppingAction*>(user_stepping)) {
+      stepping = new CountingSteppingAction(user_stepping);
+      app->SetUserAction(stepping);
+    }
+
+    CountingTrackingAction* tracking = new CountingTrackingAction
+      (const_cast<G4UserTrackingAction*>(app->GetUserTrackingAction()));
+    app->SetUserAction(tracking);
+
+    start = Clock::now();
+    app->BeamOn(wl.nevents);
+    G4double run_time = Seconds(Clock::now() - start);
+
+    G4double nsteps   = stepping ? stepping->GetNumberOfSteps() : -1.;
+    G4double nphotons = tracking->GetNumberOfPhotons();
+
+    std::ostringstream json;
+    json << std::setprecision(6)
+         << "{\"name\": \"" << wl.name << "\", "
+         << "\"init_macro\": \"" << wl.init_macro << "\", "
+         << "\"status\": \"ok\", "
+         << "\"events\": " << wl.nevents << ", "
+         << "\"init_time_s\": " << init_time << ", "
+         << "\"run_time_s\": " << run_time << ", "
+         << "\"events_per_s\": " << Rate(wl.nevents, run_time) << ", "
+         << "\"steps\": " << (stepping ? std::to_string((G4long) nsteps) : "null") << ", "
+         << "\"steps_per_s\": " << Rate(nsteps, run_time) << ", "
+         << "\"optical_photons\": " << (G4long) nphotons << ", "
+         << "\"optical_photons_per_s\": " << Rate(nphotons, run_time) << ", ";
+
+    // Closing the output file is accounted as persistency time
+    G4double generation = app->GetGenerationTime();
+    G4double tracking_time = app->GetTrackingTime();
+    G4double persistency = app->GetPersistencyTime();
+    start = Clock::now();
+    delete app;
+    persistency += Seconds(Clock::now() - start);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    json << "\"time_split_s\": {\"generation\": " << generation
+         << ", \"tracking\": " << tracking_time
+         << ", \"persistency\": " << persistency << "}, "
+         << "\"peak_rss_mb\": " << usage.ru_maxrss / 1024. << "}";
+
+    return json.str();
+  }
+
+
+  /// Run a workload in a child process and collect its results
+  G4String ForkWorkload(const Workload& wl)
+  {
+    G4String failed = "{\"name\": \"" + wl.name + "\", \"init_macro\": \"" +
+      wl.init_macro + "\", \"status\": \"failed\"}";
+
+    int fd[2];
+    if (pipe(fd) != 0) return failed;
+
+    pid_t pid = fork();
+    if (pid < 0) return failed;
+
+    if (pid == 0) {
+      close(fd[0]);
+      G4String json = RunWorkload(wl);
+      ssize_t written = write(fd[1], json.data(), json.size());
+      close(fd[1]);
+      _exit(written == (ssize_t) json.size() ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    close(fd[1]);
+    G4String json;
+    char buffer[4096];
+    ssize_t n;
+    while ((n = read(fd[0], buffer, sizeof(buffer))) > 0)
+      json.append(buffer, n);
+    close(fd[0]);
+
+    int status;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS || json.empty())
+      return failed;
+
+    return json;
+  }
+
+} // end namespace
+
+
+void PrintUsage()
+{
+  G4cerr << "\nUsage: ./nexus-bench [-n number] [-o file] [-t tag] "
+         << "[workload|init_macro ...]\n" << G4endl;
+  G4cerr << "Available options:" << G4endl;
+  G4cerr << "   -n, --nevents         : Number of events (overrides the default of each workload)\n"
+         << "   -o, --output          : Output JSON file (default: nexus-bench.json)\n"
+         << "   -t, --tag             : Label stored with the results (e.g., version)\n"
+         << "   -l, --list            : List the standard workloads\n\n"
+         << "If no workload is given, all standard workloads are run."
+         << G4endl;
+  exit(EXIT_FAILURE);
+}
+
+
+G4int main(int argc, char** argv)
+{
+  ////////////////////////////////////////////////////////////////////
+  // PARSE COMMAND-LINE OPTIONS
+
+  G4int nevents = 0;
+  G4String output = "nexus-bench.json";
+  G4String tag = "";
+
+  static struct option long_options[] =
+  {
+    {"nevents", required_argument, 0, 'n'},
+    {"output",  required_argument, 0, 'o'},
+    {"tag",     required_argument, 0, 't'},
+    {"list",    no_argument,       0, 'l'},
+    {"help",    no_argument,       0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  int c;
+
+  while (true) {
+
+    opterr = 0;
+    c = getopt_long(argc, argv, "n:o:t:lh", long_options, 0);
+
+    if (c==-1) break; // Exit if we are done reading options
+
+    switch (c) {
+
+      case 'n':
+        nevents = atoi(optarg);
+        break;
+
+      case 'o':
+        output = optarg;
+        break;
+
+      case 't':
+        tag = optarg;
+        break;
+
+      case 'l':
+        for (const Workload& wl: standard_workloads)
+          G4cout << wl.name << " (" << wl.nevents << " events): "
+                 << wl.init_macro << G4endl;
+        return EXIT_SUCCESS;
+
+      default:
+        PrintUsage();
+    }
+  }
+
+  // Remaining arguments are either names of standard
+  // workloads or initialization macros
+  std::vector<Workload> workloads;
+
+  for (G4int i=optind; i<argc; ++i) {
+    G4String arg = argv[i];
+    G4bool found = false;
+    for (const Workload& wl: standard_workloads) {
+      if (wl.name == arg) {
+        workloads.push_back(wl);
+        found = true;
+        break;
+      }
+    }
+    if (found) continue;
+
+    if (std::ifstream(arg).good()) {
+      G4String name = arg.substr(arg.find_last_of('/') + 1);
+      workloads.push_back({name, arg, 10});
+    } else {
+      G4cerr << "Unknown workload: " << arg << G4endl;
+      PrintUsage();
+    }
+  }
+
+  if (workloads.empty())
+    workloads.assign(std::begin(standard_workloads), std::end(standard_workloads));
+
+  if (nevents > 0)
+    for (Workload& wl: workloads) wl.nevents = nevents;
+
+  ////////////////////////////////////////////////////////////////////
+
+  std::time_t now = std::time(0);
+  char timestamp[32];
+  std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", std::gmtime(&now));
+
+  char host[256] = "";
+  gethostname(host, sizeof(host)-1);
+
+  std::ostringstream json;
+  json << "{\n  \"benchmark\": \"nexus-bench\",\n"
+       << "  \"tag\": \"" << tag << "\",\n"
+       << "  \"timestamp\": \"" << timestamp << "Z\",\n"
+       << "  \"host\": \"" << host << "\",\n"
+       << "  \"geant4_version\": " << G4VERSION_NUMBER << ",\n"
+       << "  \"workloads\": [\n";
+
+  for (size_t i=0; i<workloads.size(); ++i) {
+    G4cout << "[nexus-bench] Running " << workloads[i].name << " ("
+           << workloads[i].nevents << " events)" << G4endl;
+    json << "    " << ForkWorkload(workloads[i])
+         << (i+1 < workloads.size() ? ",\n" : "\n");
+  }
+
+  json << "  ]\n}\n";
+
+  std::ofstream out(output);
+  out << json.str();
+  out.close();
+
+  G4cout << "[nexus-bench] Results written to " << output << G4endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,166 @@
+// ----------------------------------------------------------------------------
+// nexus | nexus-genbb.cc
+//
+// Converts genbb (Decay0) ascii files into an indexed binary genbb store
+// (see GenbbStore), which the Decay0Interface generator reads without
+// parsing and with random access to any event. The events of several
+// input files are concatenated in the order given.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "GenbbStore.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+using namespace nexus;
+
+
+namespace {
+
+  void Fail(const std::string& msg)
+  {
+    throw std::runtime_error(msg);
+  }
+
+
+  /// Appends the events of a genbb ascii file to the store,
+  /// recording the first particle of each one in the index
+  void ConvertFile(const std::string& filename, std::ofstream& output,
+                   std::vector<uint64_t>& index, uint64_t& nparticles)
+  {
+    std::ifstream input(filename);
+    if (!input.is_open()) Fail("cannot open input file " + filename);
+
+    // The events start two lines after the "First event" one
+    std::string line;
+    while (line.find("First event") == std::string::npos)
+      if (!std::getline(input, line)) Fail(filename + " is not a genbb file");
+    std::getline(input, line);
+    std::getline(input, line);
+
+    long evt_no;
+    double evt_time;
+    int entries;
+
+    while (input >> evt_no >> evt_time >> entries) {
+      index.push_back(nparticles);
+
+      for (int i=0; i<entries; ++i) {
+        GenbbParticle particle;
+        std::memset(&particle, 0, sizeof(particle));
+        if (!(input >> particle.g3code >> particle.px >> particle.py
+                    >> particle.pz >> particle.time))
+          Fail("truncated event in " + filename);
+        output.write(reinterpret_cast<const char*>(&particle), sizeof(particle));
+        ++nparticles;
+      }
+    }
+
+    if (!input.eof()) Fail("wrong format in " + filename);
+  }
+
+} // end anonymous namespace
+
+
+
+void PrintUsage()
+{
+  std::cerr << "\nUsage: ./nexus-genbb -o output.gbb input.genbb [input.genbb ...]\n"
+            << std::endl;
+  std::cerr << "Available options:" << std::endl;
+  std::cerr << "   -o, --output          : Output genbb store\n"
+            << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char** argv)
+{
+  ////////////////////////////////////////////////////////////////////
+  // PARSE COMMAND-LINE OPTIONS
+
+  std::string output = "";
+
+  static struct option long_options[] =
+  {
+    {"output", required_argument, 0, 'o'},
+    {"help",   no_argument,       0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  int c;
+
+  while (true) {
+
+    opterr = 0;
+    c = getopt_long(argc, argv, "o:h", long_options, 0);
+
+    if (c==-1) break; // Exit if we are done reading options
+
+    switch (c) {
+
+      case 'o':
+        output = optarg;
+        break;
+
+      default:
+        PrintUsage();
+    }
+  }
+
+  if (output == "" || optind >= argc) PrintUsage();
+
+  ////////////////////////////////////////////////////////////////////
+
+  try {
+    std::ofstream file(output, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) Fail("cannot create output file " + output);
+
+    // The header is written again once the counts are known
+    GenbbStoreHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, genbb_store_magic, sizeof(header.magic));
+    header.version = genbb_store_version;
+    header.record_size = sizeof(GenbbParticle);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    std::vector<uint64_t> index;
+    uint64_t nparticles = 0;
+
+    for (int i=optind; i<argc; ++i)
+      ConvertFile(argv[i], file, index, nparticles);
+
+    header.nevents = index.size();
+    header.nparticles = nparticles;
+    header.index_offset = sizeof(header) + nparticles * sizeof(GenbbParticle);
+
+    index.push_back(nparticles);
+    file.write(reinterpret_cast<const char*>(index.data()),
+               index.size() * sizeof(uint64_t));
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (!file.good()) Fail("error writing " + output);
+
+    std::cout << "Converted " << header.nevents << " events ("
+              << header.nparticles << " particles) into " << output << std::endl;
+  }
+  catch (const std::exception& e) {
+    std::cerr << "[nexus-genbb] ERROR: " << e.what() << std::endl;
+    std::remove(output.c_str());
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,816 @@
+// ----------------------------------------------------------------------------
+// nexus | nexus-merge.cc
+//
+// Merges nexus HDF5 output files. Tables are concatenated in large blocks,
+// copying the compressed chunks as they are whenever the layout of input
+// and output allows it. Event numbers are either validated (no event number
+// may appear in more than one input file) or shifted so that each file
+// continues the numbering of the previous one. Sensor positions are written
+// once and the event counters of the configuration table are summed.
+//
+// The event index of the input files, if present, gives the event range of
+// each file without scanning the tables, allows a range of events to be
+// extracted and is merged into the event index of the output file.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "hdf5_functions.h"
+
+#include <hdf5.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+
+
+namespace {
+
+  /// Description of an output table with an event number column,
+  /// including the fields of the event index that refer to it
+  struct EventTable {
+    std::string group;
+    std::string name;
+    hsize_t (*create_type)();
+    size_t row_size;
+    size_t event_id_offset;
+    size_t index_first_offset;
+    size_t index_count_offset;
+  };
+
+  const EventTable event_tables[] = {
+    {"/MC",    "sns_response", createSensorDataType,   sizeof(sns_data_t),      HOFFSET(sns_data_t,      event_id),
+     HOFFSET(event_index_t, first_sns_response), HOFFSET(event_index_t, n_sns_response)},
+    {"/MC",    "hits",         createHitInfoType,      sizeof(hit_info_t),      HOFFSET(hit_info_t,      event_id),
+     HOFFSET(event_index_t, first_hit),          HOFFSET(event_index_t, n_hits)},
+    {"/MC",    "particles",    createParticleInfoType, sizeof(particle_info_t), HOFFSET(particle_info_t, event_id),
+     HOFFSET(event_index_t, first_particle),     HOFFSET(event_index_t, n_particles)},
+    {"/DEBUG", "steps",        createStepType,         sizeof(step_info_t),     HOFFSET(step_info_t,     event_id),
+     HOFFSET(event_index_t, first_step),         HOFFSET(event_index_t, n_steps)}
+  };
+
+  const size_t n_event_tables = sizeof(event_tables) / sizeof(EventTable);
+
+  const std::string event_index_path = "/MC/event_index";
+
+  /// Configuration parameters that are summed over the input files
+  const char* summed_params[] = {"num_events", "saved_events", "interacting_events",
+                                 "decay0_trials", "decay0_accepted",
+                                 "optical_killed_volume", "optical_killed_reflections",
+                                 "optical_killed_length", "optical_killed_time"};
+
+
+  void Fail(const std::string& msg)
+  {
+    throw std::runtime_error(msg);
+  }
+
+
+  bool Exists(hid_t file, const std::string& path)
+  {
+    // Check each level of the path, since H5Lexists fails
+    // if an intermediate group does not exist
+    size_t pos = 0;
+    while ((pos = path.find('/', pos + 1)) != std::string::npos)
+      if (H5Lexists(file, path.substr(0, pos).c_str(), H5P_DEFAULT) <= 0)
+        return false;
+    return H5Lexists(file, path.c_str(), H5P_DEFAULT) > 0;
+  }
+
+
+  hsize_t NumberOfRows(hid_t dataset)
+  {
+    hid_t space = H5Dget_space(dataset);
+    hsize_t dims[1] = {0};
+    H5Sget_simple_extent_dims(space, dims, NULL);
+    H5Sclose(space);
+    return dims[0];
+  }
+
+
+  void ReadRows(hid_t dataset, hid_t memtype, hsize_t start, hsize_t count, void* buffer)
+  {
+    hid_t file_space = H5Dget_space(dataset);
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &start, NULL, &count, NULL);
+    hid_t mem_space = H5Screate_simple(1, &count, NULL);
+    herr_t status = H5Dread(dataset, memtype, mem_space, file_space, H5P_DEFAULT, buffer);
+    H5Sclose(mem_space);
+    H5Sclose(file_space);
+    if (status < 0) Fail("cannot read from dataset");
+  }
+
+
+  void WriteRows(hid_t dataset, hid_t memtype, hsize_t start, hsize_t count, const void* buffer)
+  {
+    hid_t file_space = H5Dget_space(dataset);
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, &start, NULL, &count, NULL);
+    hid_t mem_space = H5Screate_simple(1, &count, NULL);
+    herr_t status = H5Dwrite(dataset, memtype, mem_space, file_space, H5P_DEFAULT, buffer);
+    H5Sclose(mem_space);
+    H5Sclose(file_space);
+    if (status < 0) Fail("cannot write to dataset");
+  }
+
+
+  void Extend(hid_t dataset, hsize_t nrows)
+  {
+    if (H5Dset_extent(dataset, &nrows) < 0) Fail("cannot extend dataset");
+  }
+
+
+  /// Chunk size of a dataset (0 if it is not chunked)
+  hsize_t ChunkSize(hid_t dataset)
+  {
+    hid_t plist = H5Dget_create_plist(dataset);
+    hsize_t chunk = 0;
+    if (H5Pget_layout(plist) == H5D_CHUNKED)
+      H5Pget_chunk(plist, 1, &chunk);
+    H5Pclose(plist);
+    return chunk;
+  }
+
+
+  /// Whether raw chunks of src can be copied into dst: same
+  /// datatype, same chunk size and same filter pipeline
+  bool SameLayout(hid_t src, hid_t dst)
+  {
+    hsize_t chunk = ChunkSize(src);
+    if (chunk == 0 || chunk != ChunkSize(dst)) return false;
+
+    hid_t src_type = H5Dget_type(src);
+    hid_t dst_type = H5Dget_type(dst);
+    bool same = H5Tequal(src_type, dst_type) > 0;
+    H5Tclose(src_type);
+    H5Tclose(dst_type);
+    if (!same) return false;
+
+    hid_t src_plist = H5Dget_create_plist(src);
+    hid_t dst_plist = H5Dget_create_plist(dst);
+    int nfilters = H5Pget_nfilters(src_plist);
+    same = (nfilters == H5Pget_nfilters(dst_plist));
+    for (int i=0; same && i<nfilters; ++i) {
+      unsigned int flags;
+      size_t nelmts = 0;
+      H5Z_filter_t src_filter =
+        H5Pget_filter2(src_plist, i, &flags, &nelmts, NULL, 0, NULL, NULL);
+      nelmts = 0;
+      H5Z_filter_t dst_filter =
+        H5Pget_filter2(dst_plist, i, &flags, &nelmts, NULL, 0, NULL, NULL);
+      same = (src_filter == dst_filter);
+    }
+    H5Pclose(src_plist);
+    H5Pclose(dst_plist);
+    return same;
+  }
+
+
+  /// Rows of a table to be copied
+  struct RowRange {
+    hsize_t first, count;
+  };
+
+
+  /// Input file with the range of event numbers it contains
+  struct Input {
+    std::string name;
+    hid_t file;
+    int32_t min_evt, max_evt;
+    int64_t offset;
+    bool indexed; ///< Whether the file has an event index
+    std::vector<event_index_t> index; ///< Index of the selected events
+    RowRange ranges[n_event_tables];  ///< Rows of the selected events
+  };
+
+
+  uint64_t IndexField(const event_index_t& row, size_t offset)
+  {
+    uint64_t value;
+    std::memcpy(&value, reinterpret_cast<const char*>(&row) + offset, sizeof(value));
+    return value;
+  }
+
+
+  void SetIndexField(event_index_t& row, size_t offset, uint64_t value)
+  {
+    std::memcpy(reinterpret_cast<char*>(&row) + offset, &value, sizeof(value));
+  }
+
+
+  /// Reads the event index of an input file, keeping the entries of the
+  /// events in [first_evt, last_evt], and sets from them the event range
+  /// and the rows of each table to be copied. Events are written in
+  /// increasing order, so the rows of the selected events are contiguous.
+  void ReadEventIndex(Input& input, int32_t first_evt, int32_t last_evt, hsize_t block)
+  {
+    hid_t memtype = createEventIndexType();
+    hid_t dataset = H5Dopen2(input.file, event_index_path.c_str(), H5P_DEFAULT);
+    hsize_t nrows = NumberOfRows(dataset);
+
+    std::vector<event_index_t> rows;
+    int32_t previous = 0;
+    bool first = true;
+    for (hsize_t start=0; start<nrows; start+=block) {
+      hsize_t count = std::min(block, nrows - start);
+      rows.resize(count);
+      ReadRows(dataset, memtype, start, count, rows.data());
+      for (const event_index_t& row: rows) {
+        if (!first && row.event_id <= previous)
+          Fail("event index of " + input.name + " is not sorted");
+        previous = row.event_id;
+        first = false;
+        if (row.event_id >= first_evt && row.event_id <= last_evt)
+          input.index.push_back(row);
+      }
+    }
+
+    H5Dclose(dataset);
+    H5Tclose(memtype);
+
+    input.indexed = true;
+    input.min_evt = std::numeric_limits<int32_t>::max();
+    input.max_evt = std::numeric_limits<int32_t>::min();
+    if (!input.index.empty()) {
+      input.min_evt = input.index.front().event_id;
+      input.max_evt = input.index.back().event_id;
+    }
+
+    for (size_t t=0; t<n_event_tables; ++t) {
+      RowRange& range = input.ranges[t];
+      range.first = range.count = 0;
+      if (input.index.empty()) continue;
+      const event_index_t& last = input.index.back();
+      range.first = IndexField(input.index.front(), event_tables[t].index_first_offset);
+      range.count = IndexField(last, event_tables[t].index_first_offset) +
+        IndexField(last, event_tables[t].index_count_offset) - range.first;
+    }
+  }
+
+
+  /// Finds the range of event numbers of an input
+  /// file, reading only the event number column
+  void ScanEventRange(Input& input, hsize_t block)
+  {
+    input.indexed = false;
+    input.min_evt = std::numeric_limits<int32_t>::max();
+    input.max_evt = std::numeric_limits<int32_t>::min();
+
+    hid_t memtype = H5Tcreate(H5T_COMPOUND, sizeof(int32_t));
+    H5Tinsert(memtype, "event_id", 0, H5T_NATIVE_INT32);
+
+    std::vector<int32_t> ids;
+    for (size_t t=0; t<n_event_tables; ++t) {
+      const EventTable& table = event_tables[t];
+      input.ranges[t].first = input.ranges[t].count = 0;
+
+      std::string path = table.group + "/" + table.name;
+      if (!Exists(input.file, path)) continue;
+
+      hid_t dataset = H5Dopen2(input.file, path.c_str(), H5P_DEFAULT);
+      hsize_t nrows = NumberOfRows(dataset);
+      input.ranges[t].count = nrows;
+      for (hsize_t start=0; start<nrows; start+=block) {
+        hsize_t count = std::min(block, nrows - start);
+        ids.resize(count);
+        ReadRows(dataset, memtype, start, count, ids.data());
+        auto mm = std::minmax_element(ids.begin(), ids.end());
+        input.min_evt = std::min(input.min_evt, *mm.first);
+        input.max_evt = std::max(input.max_evt, *mm.second);
+      }
+      H5Dclose(dataset);
+    }
+
+    H5Tclose(memtype);
+  }
+
+
+  /// Merger of nexus output files
+  class Merger {
+  public:
+    Merger(const std::string& output, size_t buffer_mb);
+    ~Merger();
+
+    /// Merges the events in [first_evt, last_evt] of the inputs
+    void Merge(std::vector<Input>& inputs, bool renumber,
+               int32_t first_evt, int32_t last_evt);
+
+  private:
+    void SetEventOffsets(std::vector<Input>& inputs, bool renumber,
+                         int32_t first_evt, int32_t last_evt);
+    void CopyEventTable(size_t table, const std::vector<Input>&);
+    hsize_t CopyChunks(hid_t src, hid_t dst, hsize_t nrows, hsize_t dst_rows);
+    void MergeSensorPositions(const std::vector<Input>&);
+    void MergeEventIndex(const std::vector<Input>&);
+    void MergeConfiguration(const std::vector<Input>&);
+    hid_t Group(const std::string& name);
+
+  private:
+    hid_t file_;
+    std::map<std::string, hid_t> groups_;
+    size_t buffer_size_; ///< Size in bytes of the copy buffer
+    std::vector<char> buffer_;
+    hsize_t chunks_copied_;
+  };
+
+
+  Merger::Merger(const std::string& output, size_t buffer_mb):
+    file_(-1), buffer_size_(buffer_mb << 20), chunks_copied_(0)
+  {
+    file_ = H5Fcreate(output.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (file_ < 0) Fail("cannot create output file " + output);
+  }
+
+
+  Merger::~Merger()
+  {
+    for (auto& g: groups_) H5Gclose(g.second);
+    if (file_ >= 0) H5Fclose(file_);
+  }
+
+
+  hid_t Merger::Group(const std::string& name)
+  {
+    auto it = groups_.find(name);
+    if (it != groups_.end()) return it->second;
+    std::string group_name = name;
+    hid_t group = createGroup(file_, group_name);
+    groups_[name] = group;
+    return group;
+  }
+
+
+  void Merger::Merge(std::vector<Input>& inputs, bool renumber,
+                     int32_t first_evt, int32_t last_evt)
+  {
+    SetEventOffsets(inputs, renumber, first_evt, last_evt);
+
+    // Tables are created in the same order as in HDF5Writer
+    MergeConfiguration(inputs);
+    for (size_t t=0; t<n_event_tables; ++t)
+      if (event_tables[t].name != "steps") CopyEventTable(t, inputs);
+    MergeSensorPositions(inputs);
+    MergeEventIndex(inputs);
+    CopyEventTable(3, inputs);
+
+    if (first_evt != std::numeric_limits<int32_t>::min() ||
+        last_evt  != std::numeric_limits<int32_t>::max())
+      std::cout << "Note: the event counters of the configuration table "
+                << "refer to the complete input files" << std::endl;
+
+    std::cout << "Chunks copied without decompression: "
+              << chunks_copied_ << std::endl;
+  }
+
+
+  void Merger::SetEventOffsets(std::vector<Input>& inputs, bool renumber,
+                               int32_t first_evt, int32_t last_evt)
+  {
+    bool select = first_evt != std::numeric_limits<int32_t>::min() ||
+                  last_evt  != std::numeric_limits<int32_t>::max();
+
+    for (Input& input: inputs) {
+      if (Exists(input.file, event_index_path)) {
+        hsize_t block = std::max<size_t>(buffer_size_ / sizeof(event_index_t), 1);
+        ReadEventIndex(input, first_evt, last_evt, block);
+      } else if (select) {
+        Fail(input.name + " has no event index; events cannot be selected");
+      } else {
+        hsize_t block = std::max<size_t>(buffer_size_ / sizeof(int32_t), 1);
+        ScanEventRange(input, block);
+      }
+      input.offset = 0;
+    }
+
+    if (renumber) {
+      // Each file continues the numbering of the first one
+      int64_t next = std::numeric_limits<int32_t>::max();
+      for (const Input& input: inputs)
+        if (input.min_evt <= input.max_evt) { next = input.min_evt; break; }
+
+      for (Input& input: inputs) {
+        if (input.min_evt > input.max_evt) continue; // no events
+        input.offset = next - input.min_evt;
+        next = input.max_evt + input.offset + 1;
+        if (next - 1 > std::numeric_limits<int32_t>::max())
+          Fail("event numbers do not fit in 32 bits");
+      }
+      return;
+    }
+
+    // Without renumbering, the event ranges of the files must not overlap
+    std::vector<const Input*> sorted;
+    for (const Input& input: inputs)
+      if (input.min_evt <= input.max_evt) sorted.push_back(&input);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const Input* a, const Input* b) { return a->min_evt < b->min_evt; });
+
+    for (size_t i=1; i<sorted.size(); ++i) {
+      if (sorted[i]->min_evt <= sorted[i-1]->max_evt)
+        Fail("event numbers of " + sorted[i-1]->name + " [" +
+             std::to_string(sorted[i-1]->min_evt) + ", " +
+             std::to_string(sorted[i-1]->max_evt) + "] and " +
+             sorted[i]->name + " [" + std::to_string(sorted[i]->min_evt) +
+             ", " + std::to_string(sorted[i]->max_evt) +
+             "] overlap; use --renumber or different start_id values");
+    }
+  }
+
+
+  /// Copies the complete chunks of src into dst, which must be aligned
+  /// to the chunk boundaries. Returns the number of rows copied.
+  hsize_t Merger::CopyChunks(hid_t src, hid_t dst, hsize_t nrows, hsize_t dst_rows)
+  {
+#if H5_VERSION_GE(1,10,3)
+    hsize_t chunk = ChunkSize(dst);
+    if (dst_rows % chunk != 0 || !SameLayout(src, dst)) return 0;
+
+    hsize_t copied = 0;
+    for (; copied + chunk <= nrows; copied += chunk) {
+      hsize_t src_offset = copied;
+      hsize_t dst_offset = dst_rows + copied;
+      hsize_t size = 0;
+      if (H5Dget_chunk_storage_size(src, &src_offset, &size) < 0 || size == 0)
+        break;
+      if (buffer_.size() < size) buffer_.resize(size);
+
+      uint32_t filter_mask = 0;
+      if (H5Dread_chunk(src, H5P_DEFAULT, &src_offset, &filter_mask, buffer_.data()) < 0 ||
+          H5Dwrite_chunk(dst, H5P_DEFAULT, filter_mask, &dst_offset, size, buffer_.data()) < 0)
+        Fail("cannot copy chunk");
+      ++chunks_copied_;
+    }
+    return copied;
+#else
+    (void) src; (void) dst; (void) nrows; (void) dst_rows;
+    return 0;
+#endif
+  }
+
+
+  void Merger::CopyEventTable(size_t t, const std::vector<Input>& inputs)
+  {
+    const EventTable& table = event_tables[t];
+    std::string path = table.group + "/" + table.name;
+
+    bool found = false;
+    for (const Input& input: inputs)
+      found = found || Exists(input.file, path);
+    if (!found) return;
+
+    hid_t memtype = table.create_type();
+    std::string name = table.name;
+    hid_t dst = createTable(Group(table.group), name, memtype);
+
+    hsize_t block = std::max<size_t>(buffer_size_ / table.row_size, 1);
+    hsize_t dst_rows = 0;
+
+    for (const Input& input: inputs) {
+      if (!Exists(input.file, path)) {
+        std::cerr << "Warning: " << input.name << " has no table "
+                  << path << std::endl;
+        continue;
+      }
+
+      hid_t src = H5Dopen2(input.file, path.c_str(), H5P_DEFAULT);
+      hsize_t first = input.ranges[t].first;
+      hsize_t nrows = input.ranges[t].count;
+      if (first + nrows > NumberOfRows(src))
+        Fail("event index of " + input.name + " does not match " + path);
+      Extend(dst, dst_rows + nrows);
+
+      // Raw chunks can only be copied if event numbers are kept
+      // and the rows start at the beginning of the table
+      hsize_t start = (input.offset == 0 && first == 0) ?
+        CopyChunks(src, dst, nrows, dst_rows) : 0;
+
+      if (start < nrows && buffer_.size() < std::min(block, nrows) * table.row_size)
+        buffer_.resize(std::min(block, nrows) * table.row_size);
+
+      for (; start<nrows; start+=block) {
+        hsize_t count = std::min(block, nrows - start);
+        ReadRows(src, memtype, first + start, count, buffer_.data());
+
+        if (input.offset != 0) {
+          char* row = buffer_.data() + table.event_id_offset;
+          for (hsize_t i=0; i<count; ++i, row+=table.row_size) {
+            int32_t evt;
+            std::memcpy(&evt, row, sizeof(evt));
+            evt = static_cast<int32_t>(evt + input.offset);
+            std::memcpy(row, &evt, sizeof(evt));
+          }
+        }
+
+        WriteRows(dst, memtype, dst_rows + start, count, buffer_.data());
+      }
+
+      dst_rows += nrows;
+      H5Dclose(src);
+    }
+
+    std::cout << path << ": " << dst_rows << " rows" << std::endl;
+
+    H5Dclose(dst);
+    H5Tclose(memtype);
+  }
+
+
+  void Merger::MergeSensorPositions(const std::vector<Input>& inputs)
+  {
+    const std::string path = "/MC/sns_positions";
+    hid_t memtype = createSensorPosType();
+
+    std::vector<sns_pos_t> sensors;
+    std::map<unsigned int, size_t> index;
+    size_t conflicts = 0;
+
+    for (const Input& input: inputs) {
+      if (!Exists(input.file, path)) continue;
+
+      hid_t src = H5Dopen2(input.file, path.c_str(), H5P_DEFAULT);
+      hsize_t nrows = NumberOfRows(src);
+      std::vector<sns_pos_t> rows(nrows);
+      if (nrows > 0) ReadRows(src, memtype, 0, nrows, rows.data());
+      H5Dclose(src);
+
+      for (const sns_pos_t& row: rows) {
+        auto it = index.find(row.sensor_id);
+        if (it == index.end()) {
+          index[row.sensor_id] = sensors.size();
+          sensors.push_back(row);
+          continue;
+        }
+        const sns_pos_t& first = sensors[it->second];
+        if (std::strncmp(first.sensor_name, row.sensor_name, STRLEN) != 0 ||
+            std::fabs(first.x - row.x) > 1.e-3 ||
+            std::fabs(first.y - row.y) > 1.e-3 ||
+            std::fabs(first.z - row.z) > 1.e-3) {
+          if (conflicts++ == 0)
+            std::cerr << "Warning: sensor " << row.sensor_id << " in "
+                      << input.name << " differs from the first file "
+                      << "where it appears; the first one is kept" << std::endl;
+        }
+      }
+    }
+
+    if (conflicts > 1)
+      std::cerr << "Warning: " << conflicts
+                << " sensor positions differ between input files" << std::endl;
+
+    std::string name = "sns_positions";
+    hid_t dst = createTable(Group("/MC"), name, memtype);
+    Extend(dst, sensors.size());
+    if (!sensors.empty()) WriteRows(dst, memtype, 0, sensors.size(), sensors.data());
+
+    std::cout << path << ": " << sensors.size() << " rows" << std::endl;
+
+    H5Dclose(dst);
+    H5Tclose(memtype);
+  }
+
+
+  void Merger::MergeEventIndex(const std::vector<Input>& inputs)
+  {
+    for (const Input& input: inputs) {
+      if (input.indexed) continue;
+      std::cerr << "Warning: " << input.name << " has no event index; "
+                << "the output file will not have one" << std::endl;
+      return;
+    }
+
+    hid_t memtype = createEventIndexType();
+    std::string name = "event_index";
+    hid_t dst = createTable(Group("/MC"), name, memtype);
+
+    // Rows of each table written to the output by the previous inputs
+    uint64_t written[n_event_tables] = {0};
+    hsize_t dst_rows = 0;
+
+    for (const Input& input: inputs) {
+      std::vector<event_index_t> rows = input.index;
+      for (event_index_t& row: rows) {
+        row.event_id = static_cast<int32_t>(row.event_id + input.offset);
+        for (size_t t=0; t<n_event_tables; ++t) {
+          size_t offset = event_tables[t].index_first_offset;
+          SetIndexField(row, offset, IndexField(row, offset) -
+                        input.ranges[t].first + written[t]);
+        }
+      }
+
+      Extend(dst, dst_rows + rows.size());
+      if (!rows.empty()) WriteRows(dst, memtype, dst_rows, rows.size(), rows.data());
+      dst_rows += rows.size();
+
+      for (size_t t=0; t<n_event_tables; ++t)
+        written[t] += input.ranges[t].count;
+    }
+
+    std::cout << event_index_path << ": " << dst_rows << " rows" << std::endl;
+
+    H5Dclose(dst);
+    H5Tclose(memtype);
+  }
+
+
+  void Merger::MergeConfiguration(const std::vector<Input>& inputs)
+  {
+    const std::string path = "/MC/configuration";
+    hid_t memtype = createRunType();
+
+    // The configuration holds one row per macro command, so keys such
+    // as /PhysicsList/RegisterPhysics may legitimately repeat. The rows
+    // of the first file are kept in order, except for the event counters,
+    // which are summed over the files (and kept once), and the decay0
+    // acceptance, recomputed from them. The rest of the rows of every
+    // other file are compared, as a whole, with those of the first one.
+    std::vector<run_info_t> params;
+    std::vector<run_info_t> reference;
+    std::map<std::string, size_t> counters;
+    std::map<std::string, long long> sums;
+    bool first = true;
+
+    for (const Input& input: inputs) {
+      if (!Exists(input.file, path)) continue;
+
+      hid_t src = H5Dopen2(input.file, path.c_str(), H5P_DEFAULT);
+      hsize_t nrows = NumberOfRows(src);
+      std::vector<run_info_t> rows(nrows);
+      if (nrows > 0) ReadRows(src, memtype, 0, nrows, rows.data());
+      H5Dclose(src);
+
+      std::vector<run_info_t> others;
+
+      for (const run_info_t& row: rows) {
+        std::string key(row.param_key, strnlen(row.param_key, CONFLEN));
+
+        bool summed = false;
+        for (const char* p: summed_params) summed = summed || (key == p);
+        if (summed)
+          sums[key] += std::atoll(row.param_value);
+
+        if (summed || key == "decay0_acceptance") {
+          if (counters.find(key) == counters.end()) {
+            counters[key] = params.size();
+            params.push_back(row);
+          }
+          continue;
+        }
+
+        others.push_back(row);
+        if (first) params.push_back(row);
+      }
+
+      if (first) {
+        reference = others;
+        first = false;
+        continue;
+      }
+
+      bool same = (others.size() == reference.size());
+      for (size_t i=0; same && i<others.size(); ++i)
+        same = std::strncmp(others[i].param_key, reference[i].param_key, CONFLEN) == 0 &&
+               std::strncmp(others[i].param_value, reference[i].param_value, CONFLEN) == 0;
+      if (!same)
+        std::cerr << "Note: the configuration of " << input.name
+                  << " differs from that of the first file, which is kept" << std::endl;
+    }
+
+    for (auto& counter: counters) {
+      auto it = sums.find(counter.first);
+      if (it == sums.end()) continue;
+      run_info_t& param = params[counter.second];
+      std::memset(param.param_value, 0, CONFLEN);
+      std::strncpy(param.param_value, std::to_string(it->second).c_str(), CONFLEN - 1);
+    }
+
+    // The decay0 acceptance is recomputed from the summed counters
+    auto acceptance = counters.find("decay0_acceptance");
+    if (acceptance != counters.end() && sums["decay0_trials"] > 0) {
+      char value[CONFLEN];
+      snprintf(value, CONFLEN, "%.10g",
+               (double) sums["decay0_accepted"] / sums["decay0_trials"]);
+      run_info_t& param = params[acceptance->second];
+      std::memset(param.param_value, 0, CONFLEN);
+      std::strncpy(param.param_value, value, CONFLEN - 1);
+    }
+
+    std::string name = "configuration";
+    hid_t dst = createTable(Group("/MC"), name, memtype);
+    Extend(dst, params.size());
+    if (!params.empty()) WriteRows(dst, memtype, 0, params.size(), params.data());
+
+    H5Dclose(dst);
+    H5Tclose(memtype);
+  }
+
+} // end namespace
+
+
+void PrintUsage()
+{
+  std::cerr << "\nUsage: ./nexus-merge [-r] [-e first:last] [-m megabytes] -o output.h5 "
+            << "input.h5 [input.h5 ...]\n" << std::endl;
+  std::cerr << "Available options:" << std::endl;
+  std::cerr << "   -o, --output          : Output file\n"
+            << "   -r, --renumber        : Shift event numbers so that each file continues the previous one\n"
+            << "                           (by default, overlapping event numbers are an error)\n"
+            << "   -e, --events          : Copy only the events in [first, last] (requires the event index)\n"
+            << "   -m, --memory          : Size of the copy buffer in MB (default: 256)\n"
+            << std::endl;
+  exit(EXIT_FAILURE);
+}
+
+
+int main(int argc, char** argv)
+{
+  ////////////////////////////////////////////////////////////////////
+  // PARSE COMMAND-LINE OPTIONS
+
+  std::string output = "";
+  bool renumber = false;
+  size_t buffer_mb = 256;
+  int32_t first_evt = std::numeric_limits<int32_t>::min();
+  int32_t last_evt  = std::numeric_limits<int32_t>::max();
+
+  static struct option long_options[] =
+  {
+    {"output",   required_argument, 0, 'o'},
+    {"renumber", no_argument,       0, 'r'},
+    {"events",   required_argument, 0, 'e'},
+    {"memory",   required_argument, 0, 'm'},
+    {"help",     no_argument,       0, 'h'},
+    {0, 0, 0, 0}
+  };
+
+  int c;
+
+  while (true) {
+
+    opterr = 0;
+    c = getopt_long(argc, argv, "o:re:m:h", long_options, 0);
+
+    if (c==-1) break; // Exit if we are done reading options
+
+    switch (c) {
+
+      case 'o':
+        output = optarg;
+        break;
+
+      case 'r':
+        renumber = true;
+        break;
+
+      case 'e':
+        if (sscanf(optarg, "%d:%d", &first_evt, &last_evt) != 2 || first_evt > last_evt)
+          PrintUsage();
+        break;
+
+      case 'm':
+        buffer_mb = std::max(atoi(optarg), 1);
+        break;
+
+      default:
+        PrintUsage();
+    }
+  }
+
+  if (output == "" || optind >= argc) PrintUsage();
+
+  ////////////////////////////////////////////////////////////////////
+
+  std::vector<Input> inputs;
+  int status = EXIT_SUCCESS;
+
+  try {
+    for (int i=optind; i<argc; ++i) {
+      if (output == argv[i]) Fail("the output file is also an input");
+      hid_t file = H5Fopen(argv[i], H5F_ACC_RDONLY, H5P_DEFAULT);
+      if (file < 0) Fail(std::string("cannot open input file ") + argv[i]);
+      Input input;
+      input.name = argv[i];
+      input.file = file;
+      inputs.push_back(input);
+    }
+
+    Merger merger(output, buffer_mb);
+    merger.Merge(inputs, renumber, first_evt, last_evt);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "nexus-merge: " << e.what() << std::endl;
+    std::remove(output.c_str());
+    status = EXIT_FAILURE;
+  }
+
+  for (const Input& input: inputs) H5Fclose(input.file);
+
+  return status;
+}
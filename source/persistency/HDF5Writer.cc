@@ -21,7 +21,8 @@ using namespace nexus;
 
 HDF5Writer::HDF5Writer():
   file_(0), irun_(0), ismp_(0), ihit_(0),
-  ipart_(0), ipos_(0), istep_(0)
+  ipart_(0), ipos_(0), istep_(0), iidx_(0),
+  idx_smp_(0), idx_hit_(0), idx_part_(0), idx_step_(0)
 {
 }
 
@@ -59,6 +60,10 @@ void HDF5Writer::Open(std::string fileName, bool debug)
   memtypeSnsPos_ = createSensorPosType();
   snsPosTable_ = createTable(group, sns_pos_table_name, memtypeSnsPos_);
 
+  std::string event_index_table_name = "event_index";
+  memtypeEventIndex_ = createEventIndexType();
+  eventIndexTable_ = createTable(group, event_index_table_name, memtypeEventIndex_);
+
   if (debug) {
     std::string debug_group_name = "/DEBUG";
     size_t debug_group = createGroup(file_, debug_group_name);
@@ -119,7 +124,7 @@ void HDF5Writer::WriteHitInfo(int evt_number, int particle_indx, int hit_indx, f
   ihit_++;
 }
 
-void HDF5Writer::WriteParticleInfo(int evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc)
+void HDF5Writer::WriteParticleInfo(int evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc, float weight)
 {
   particle_info_t trueInfo;
   trueInfo.event_id = evt_number;
@@ -152,6 +157,7 @@ void HDF5Writer::WriteParticleInfo(int evt_number, int particle_indx, const char
   strcpy(trueInfo.creator_proc, creator_proc);
   memset(trueInfo.final_proc, 0, STRLEN);
   strcpy(trueInfo.final_proc, final_proc);
+  trueInfo.weight = weight;
   writeParticle(&trueInfo,  particleInfoTable_, memtypeParticleInfo_, ipart_);
 
   ipart_++;
@@ -203,3 +209,37 @@ void HDF5Writer::WriteStep(int evt_number,
 
   istep_++;
 }
+
+void HDF5Writer::WriteEventIndex(int evt_number)
+{
+  event_index_t index;
+  index.event_id = evt_number;
+  index.first_sns_response = idx_smp_;
+  index.n_sns_response = ismp_ - idx_smp_;
+  index.first_hit = idx_hit_;
+  index.n_hits = ihit_ - idx_hit_;
+  index.first_particle = idx_part_;
+  index.n_particles = ipart_ - idx_part_;
+  index.first_step = idx_step_;
+  index.n_steps = istep_ - idx_step_;
+  writeEventIndex(&index, eventIndexTable_, memtypeEventIndex_, iidx_);
+
+  idx_smp_ = ismp_;
+  idx_hit_ = ihit_;
+  idx_part_ = ipart_;
+  idx_step_ = istep_;
+  iidx_++;
+}
+
+
+
+size_t HDF5Writer::GetBytesWritten() const
+{
+  return irun_  * sizeof(run_info_t)
+       + ismp_  * sizeof(sns_data_t)
+       + ihit_  * sizeof(hit_info_t)
+       + ipart_ * sizeof(particle_info_t)
+       + ipos_  * sizeof(sns_pos_t)
+       + istep_ * sizeof(step_info_t)
+       + iidx_  * sizeof(event_index_t);
+}
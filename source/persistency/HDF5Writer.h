@@ -33,7 +33,7 @@ namespace nexus {
     void WriteRunInfo(const char* param_key, const char* param_value);
     void WriteSensorDataInfo(int evt_number, unsigned int sensor_id, unsigned int time_bin, unsigned int charge);
     void WriteHitInfo(int evt_number, int particle_indx, int hit_indx, float hit_position_x, float hit_position_y, float hit_position_z, float hit_time, float hit_energy, const char* label);
-    void WriteParticleInfo(int evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc);
+    void WriteParticleInfo(int evt_number, int particle_indx, const char* particle_name, char primary, int mother_id, float initial_vertex_x, float initial_vertex_y, float initial_vertex_z, float initial_vertex_t, float final_vertex_x, float final_vertex_y, float final_vertex_z, float final_vertex_t, const char* initial_volume, const char* final_volume, float ini_momentum_x, float ini_momentum_y, float ini_momentum_z, float final_momentum_x, float final_momentum_y, float final_momentum_z, float kin_energy, float length, const char* creator_proc, const char* final_proc, float weight=1.);
     void WriteSensorPosInfo(unsigned int sensor_id, const char* sensor_name, float x, float y, float z);
     void WriteStep(int evt_number,
                    int particle_id, const char* particle_name,
@@ -44,6 +44,22 @@ namespace nexus {
                    float initial_x, float initial_y, float initial_z,
                    float   final_x, float   final_y, float   final_z);
 
+    /// Record in the event index the rows written to each
+    /// table since the previous call (i.e. those of the event)
+    void WriteEventIndex(int evt_number);
+
+    /// Number of rows written so far to each table
+    size_t GetRunInfoRows()    const { return irun_;  }
+    size_t GetSensorDataRows() const { return ismp_;  }
+    size_t GetHitInfoRows()    const { return ihit_;  }
+    size_t GetParticleRows()   const { return ipart_; }
+    size_t GetSensorPosRows()  const { return ipos_;  }
+    size_t GetStepRows()       const { return istep_; }
+    size_t GetEventIndexRows() const { return iidx_;  }
+
+    /// Size in bytes of the rows written so far (before compression)
+    size_t GetBytesWritten() const;
+
   private:
     size_t file_; ///< HDF5 file
 
@@ -57,6 +73,7 @@ namespace nexus {
     size_t particleInfoTable_;
     size_t snsPosTable_;
     size_t stepTable_;
+    size_t eventIndexTable_;
 
     size_t memtypeRun_;
     size_t memtypeSnsData_;
@@ -64,6 +81,7 @@ namespace nexus {
     size_t memtypeParticleInfo_;
     size_t memtypeSnsPos_;
     size_t memtypeStep_;
+    size_t memtypeEventIndex_;
 
     size_t irun_; ///< counter for configuration parameters
     size_t ismp_; ///< counter for written waveform samples
@@ -71,6 +89,10 @@ namespace nexus {
     size_t ipart_; ///< counter for particle information
     size_t ipos_; ///< counter for sensor positions
     size_t istep_; ///< counter for steps
+    size_t iidx_; ///< counter for indexed events
+
+    // Rows of each table at the end of the last indexed event
+    size_t idx_smp_, idx_hit_, idx_part_, idx_step_;
 
   };
 
@@ -13,13 +13,16 @@
 #include "TrajectoryMap.h"
 #include "IonizationSD.h"
 #include "PmtSD.h"
+#include "SensorRegistry.h"
 #include "NexusApp.h"
 #include "DetectorConstruction.h"
 #include "SaveAllSteppingAction.h"
 #include "GeometryBase.h"
 #include "HDF5Writer.h"
+#include "ResponseLibrary.h"
 #include "PersistencyManagerBase.h"
 #include "FactoryBase.h"
+#include "RunTelemetry.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4Event.hh>
@@ -34,6 +37,7 @@
 #include <sstream>
 #include <iostream>
 #include <string>
+#include <chrono>
 
 using namespace nexus;
 
@@ -46,7 +50,10 @@ PersistencyManager::PersistencyManager():
   store_evt_(true), store_steps_(false),
   interacting_evt_(false), event_type_("other"), saved_evts_(0),
   interacting_evts_(0), pmt_bin_size_(-1), sipm_bin_size_(-1),
-  nevt_(0), start_id_(0), first_evt_(true), h5writer_(0)
+  nevt_(0), start_id_(0), first_evt_(true),
+  sns_pos_stored_(false), h5writer_(0),
+  library_(0), overlay_(0), overlay_mean_(1.), overlay_window_(0.),
+  truth_min_energy_(0.)
 {
   msg_ = new G4GenericMessenger(this, "/nexus/persistency/");
   msg_->DeclareMethod("outputFile", &PersistencyManager::OpenFile, "");
@@ -55,6 +62,29 @@ PersistencyManager::PersistencyManager():
   msg_->DeclareProperty("start_id", start_id_,
                         "Starting event ID for this job.");
 
+  msg_->DeclareMethod("response_library", &PersistencyManager::OpenResponseLibrary,
+                      "Store the sensor responses of the events in a library file.");
+  msg_->DeclareMethod("overlay_library", &PersistencyManager::OpenOverlayLibrary,
+                      "Add sensor responses sampled from a library file to the events.");
+  msg_->DeclareProperty("overlay_mean", overlay_mean_,
+                        "Mean number (Poisson) of library entries added to each event.");
+  msg_->DeclarePropertyWithUnit("overlay_window", "ns", overlay_window_,
+                                "Library entries are delayed by a random time up to this value.");
+
+  msg_->DeclareMethod("hit_merging", &PersistencyManager::SetHitMerging,
+                      "Merge ionization deposits into voxels: none, track or event.");
+  msg_->DeclareMethodWithUnit("hit_voxel_xy", "mm", &PersistencyManager::SetHitVoxelXY,
+                              "Size in the xy plane of the voxels where hits are merged.");
+  msg_->DeclareMethodWithUnit("hit_voxel_z", "mm", &PersistencyManager::SetHitVoxelZ,
+                              "Size along z of the voxels where hits are merged.");
+  msg_->DeclareMethodWithUnit("hit_time_slice", "ns", &PersistencyManager::SetHitTimeSlice,
+                              "Duration of the time slices where hits are merged (0 for none).");
+
+  msg_->DeclarePropertyWithUnit("truth_min_energy", "keV", truth_min_energy_,
+                                "Thin the particles table, keeping particles above this kinetic energy.");
+  msg_->DeclareMethod("truth_volume", &PersistencyManager::AddTruthVolume,
+                      "Thin the particles table, keeping particles created or ending in this volume.");
+
   init_macro_ = "";
   macros_.clear();
   delayed_macros_.clear();
@@ -67,6 +97,8 @@ PersistencyManager::~PersistencyManager()
 {
   delete msg_;
   delete h5writer_;
+  delete library_;
+  delete overlay_;
 }
 
 
@@ -106,8 +138,62 @@ void PersistencyManager::OpenFile(G4String filename)
 
 
 
+void PersistencyManager::OpenResponseLibrary(G4String filename)
+{
+  if (!library_) library_ = new ResponseLibrary();
+  library_->Create(filename);
+}
+
+
+
+void PersistencyManager::OpenOverlayLibrary(G4String filename)
+{
+  if (!overlay_) overlay_ = new ResponseLibrary();
+  overlay_->Open(filename);
+}
+
+
+
+void PersistencyManager::SetHitMerging(G4String mode)
+{
+  IonizationSD::SetMergeMode(mode);
+}
+
+
+
+void PersistencyManager::SetHitVoxelXY(G4double size)
+{
+  IonizationSD::SetVoxelSizeXY(size);
+}
+
+
+
+void PersistencyManager::SetHitVoxelZ(G4double size)
+{
+  IonizationSD::SetVoxelSizeZ(size);
+}
+
+
+
+void PersistencyManager::SetHitTimeSlice(G4double slice)
+{
+  IonizationSD::SetTimeSlice(slice);
+}
+
+
+
+void PersistencyManager::AddTruthVolume(G4String volume)
+{
+  truth_volumes_.insert(volume);
+}
+
+
+
 void PersistencyManager::CloseFile()
 {
+  if (library_) library_->Close();
+  if (overlay_) overlay_->Close();
+
   if (!h5writer_) return;
 
   h5writer_->Close();
@@ -117,6 +203,9 @@ void PersistencyManager::CloseFile()
 
 G4bool PersistencyManager::Store(const G4Event* event)
 {
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+
   if (interacting_evt_) {
     interacting_evts_++;
   }
@@ -128,6 +217,8 @@ G4bool PersistencyManager::Store(const G4Event* event)
         G4RunManager::GetRunManager()->GetUserSteppingAction();
       sa->Reset();
     }
+    ReportTelemetry(std::chrono::duration<G4double>
+                    (std::chrono::steady_clock::now() - start).count());
     return false;
   }
 
@@ -136,26 +227,134 @@ G4bool PersistencyManager::Store(const G4Event* event)
   if (first_evt_) {
     first_evt_ = false;
     nevt_ = start_id_;
+    if (use_event_id_ && start_id_ != 0)
+      G4Exception("[PersistencyManager]", "Store()", JustWarning,
+                  "start_id is ignored when events are seeded individually. Use /nexus/start_event instead.");
   }
 
+  if (use_event_id_)
+    nevt_ = event->GetEventID();
+
+  if (!sns_pos_stored_)
+    StoreSensorPositions();
+
   if (store_steps_)
     StoreSteps();
 
   // Store the trajectories of the event
+  ThinTrajectories(event->GetTrajectoryContainer());
   StoreTrajectories(event->GetTrajectoryContainer());
 
+  // The library keeps the responses of the event alone,
+  // before any other response is added to it
+  if (library_)
+    library_->Write(nevt_, event->GetHCofThisEvent());
+
+  if (overlay_)
+    overlay_->Overlay(event->GetHCofThisEvent(), overlay_mean_, overlay_window_);
+
   // Store ionization hits and sensor hits
   StoreHits(event->GetHCofThisEvent());
 
+  h5writer_->WriteEventIndex(nevt_);
+
   nevt_++;
 
   TrajectoryMap::Clear();
   StoreCurrentEvent(true);
 
+  ReportTelemetry(std::chrono::duration<G4double>
+                  (std::chrono::steady_clock::now() - start).count());
+
   return true;
 }
 
 
+
+void PersistencyManager::ReportTelemetry(G4double seconds)
+{
+  RunTelemetry& telemetry = RunTelemetry::Instance();
+  if (!telemetry.IsEnabled() || !h5writer_) return;
+
+  std::map<G4String, G4long> rows;
+  rows["configuration"] = h5writer_->GetRunInfoRows();
+  rows["sns_response"]  = h5writer_->GetSensorDataRows();
+  rows["hits"]          = h5writer_->GetHitInfoRows();
+  rows["particles"]     = h5writer_->GetParticleRows();
+  rows["sns_positions"] = h5writer_->GetSensorPosRows();
+  rows["steps"]         = h5writer_->GetStepRows();
+  rows["event_index"]   = h5writer_->GetEventIndexRows();
+
+  telemetry.EndOfStore(seconds, rows, h5writer_->GetBytesWritten());
+}
+
+
+void PersistencyManager::ThinTrajectories(G4TrajectoryContainer* tc)
+{
+  truth_map_.clear();
+  if (!tc || (truth_min_energy_ <= 0. && truth_volumes_.empty())) return;
+
+  // Trajectories by track ID, and whether each of them is kept
+  std::unordered_map<G4int, Trajectory*> trajectories;
+  std::unordered_map<G4int, G4bool> kept;
+  trajectories.reserve(tc->entries());
+  kept.reserve(tc->entries());
+
+  for (size_t i=0; i<tc->entries(); ++i) {
+    Trajectory* trj = dynamic_cast<Trajectory*>((*tc)[i]);
+    if (!trj) continue;
+    trajectories[trj->GetTrackID()] = trj;
+    kept[trj->GetTrackID()] = false;
+  }
+
+  for (auto& entry: trajectories) {
+    Trajectory* trj = entry.second;
+
+    G4double mass = trj->GetParticleDefinition()->GetPDGMass();
+    G4ThreeVector ini_mom = trj->GetInitialMomentum();
+    G4double kin_energy = sqrt(ini_mom.mag2() + mass*mass) - mass;
+
+    G4bool keep = !trj->GetParentID() ||
+      (truth_min_energy_ > 0. && kin_energy >= truth_min_energy_) ||
+      truth_volumes_.count(trj->GetInitialVolume()) ||
+      truth_volumes_.count(trj->GetFinalVolume());
+    if (!keep) continue;
+
+    // Keep the particle and its ancestors, stopping
+    // at the first one already kept
+    G4int id = entry.first;
+    while (true) {
+      auto it = kept.find(id);
+      if (it == kept.end() || it->second) break;
+      it->second = true;
+      id = trajectories[id]->GetParentID();
+    }
+  }
+
+  // Particles with no kept ancestor (because the chain of trajectories
+  // is broken by an ancestor without trajectory) go to the first primary
+  G4int primary_id = 0;
+  for (auto& entry: trajectories)
+    if (!entry.second->GetParentID() && (!primary_id || entry.first < primary_id))
+      primary_id = entry.first;
+
+  // Every particle is mapped to itself, if kept,
+  // or to its nearest kept ancestor otherwise
+  for (auto& entry: kept) {
+    G4int id = entry.first;
+    while (!kept[id]) {
+      auto it = truth_map_.find(id);
+      if (it != truth_map_.end()) { id = it->second; break; }
+      G4int parent = trajectories[id]->GetParentID();
+      if (kept.find(parent) == kept.end()) { id = primary_id; break; }
+      id = parent;
+    }
+    truth_map_[entry.first] = id;
+  }
+}
+
+
+
 void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
 {
   // If the pointer is null, no trajectories were stored in this event
@@ -168,6 +367,9 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
 
     G4int trackid = trj->GetTrackID();
 
+    // Skip the particles dropped by the thinning
+    if (!truth_map_.empty() && truth_map_[trackid] != trackid) continue;
+
     G4double length = trj->GetTrackLength();
 
     G4ThreeVector ini_xyz = trj->GetInitialPosition();
@@ -204,7 +406,7 @@ void PersistencyManager::StoreTrajectories(G4TrajectoryContainer* tc)
                                  (float)final_mom.y(), (float)final_mom.z(),
 				 kin_energy, length,
                                  trj->GetCreatorProcess().c_str(),
-				 trj->GetFinalProcess().c_str());
+				 trj->GetFinalProcess().c_str(), trj->GetWeight());
 
   }
 }
@@ -264,6 +466,13 @@ void PersistencyManager::StoreIonizationHits(G4VHitsCollection* hc)
 
     G4int trackid = hit->GetTrackID();
 
+    // Hits of the particles dropped by the thinning
+    // are assigned to their nearest kept ancestor
+    if (!truth_map_.empty()) {
+      std::unordered_map<G4int, G4int>::const_iterator it = truth_map_.find(trackid);
+      if (it != truth_map_.end()) trackid = it->second;
+    }
+
     std::vector<G4int>* ihits = nullptr;
     std::map<G4int, std::vector<G4int>* >::iterator it = hit_map_.find(trackid);
     if (it != hit_map_.end()) {
@@ -294,6 +503,7 @@ void PersistencyManager::StorePmtHits(G4VHitsCollection* hc)
 
   std::string sdname = hits->GetSDname();
 
+  // Binning of sensors not known to the registry is taken from their hits
   std::map<G4String, G4double>::const_iterator sensdet_it = sensdet_bin_.find(sdname);
   if (sensdet_it == sensdet_bin_.end()) {
     for (size_t j=0; j<hits->entries(); j++) {
@@ -329,18 +539,34 @@ void PersistencyManager::StorePmtHits(G4VHitsCollection* hc)
                                      time_bin, charge);
     }
 
-    std::vector<G4int>::iterator pos_it =
-      std::find(sns_posvec_.begin(), sns_posvec_.end(), hit->GetPmtID());
-    if (pos_it == sns_posvec_.end()) {
+    // Registered sensors are written all at once at the beginning of the run
+    if (SensorRegistry::GetSlot(hit->GetPmtID()) < 0 &&
+        sns_posvec_.insert(hit->GetPmtID()).second) {
       h5writer_->WriteSensorPosInfo((unsigned int)hit->GetPmtID(), sdname.c_str(),
 				    (float)xyz.x(), (float)xyz.y(), (float)xyz.z());
-      sns_posvec_.push_back(hit->GetPmtID());
     }
 
   }
 }
 
 
+void PersistencyManager::StoreSensorPositions()
+{
+  sns_pos_stored_ = true;
+
+  const std::vector<SensorInfo>& sensors = SensorRegistry::GetSensors();
+  for (size_t i=0; i<sensors.size(); i++) {
+    const SensorInfo& sns = sensors[i];
+    h5writer_->WriteSensorPosInfo((unsigned int)sns.id, sns.name.c_str(),
+                                  (float)sns.position.x(),
+                                  (float)sns.position.y(),
+                                  (float)sns.position.z());
+    sensdet_bin_[sns.name] = sns.binning;
+  }
+}
+
+
+
 void PersistencyManager::StoreSteps()
 {
   SaveAllSteppingAction* sa = (SaveAllSteppingAction*)
@@ -376,6 +602,10 @@ void PersistencyManager::StoreSteps()
 
 G4bool PersistencyManager::Store(const G4Run*)
 {
+  // Sensors are listed in the output even if no event was stored
+  if (!sns_pos_stored_)
+    StoreSensorPositions();
+
   // Store the event type
   G4String key = "event_type";
   h5writer_->WriteRunInfo(key, event_type_.c_str());
@@ -397,6 +627,11 @@ G4bool PersistencyManager::Store(const G4Run*)
                            (std::to_string(it->second/microsecond)+" mus").c_str());
   }
 
+  std::map<G4String, G4String>::const_iterator info;
+  for (info = run_info_.begin(); info != run_info_.end(); ++info) {
+    h5writer_->WriteRunInfo(info->first.c_str(), info->second.c_str());
+  }
+
   SaveConfigurationInfo(init_macro_);
   for (unsigned long i=0; i<macros_.size(); i++) {
     SaveConfigurationInfo(macros_[i]);
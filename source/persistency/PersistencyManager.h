@@ -15,6 +15,9 @@
 #include <G4VPersistencyManager.hh>
 #include <map>
 #include <vector>
+#include <set>
+#include <unordered_set>
+#include <unordered_map>
 
 
 class G4GenericMessenger;
@@ -25,6 +28,7 @@ class G4VHitsCollection;
 namespace nexus {
   class HDF5Writer;
   class IonizationHit;
+  class ResponseLibrary;
 }
 
 namespace nexus {
@@ -58,13 +62,34 @@ namespace nexus {
     void OpenFile(G4String);
     void CloseFile();
 
+    /// Store the sensor responses of every saved event in a library file
+    void OpenResponseLibrary(G4String);
+    /// Add responses sampled from a library file to every saved event
+    void OpenOverlayLibrary(G4String);
+
+    // Merging of ionization hits (see IonizationSD)
+    void SetHitMerging(G4String);
+    void SetHitVoxelXY(G4double);
+    void SetHitVoxelZ(G4double);
+    void SetHitTimeSlice(G4double);
+
+    /// Add a volume whose particles (created or ending in it)
+    /// are kept in the particles table when thinning
+    void AddTruthVolume(G4String);
+
 
   private:
+    /// Decide which trajectories are stored, filling truth_map_
+    void ThinTrajectories(G4TrajectoryContainer*);
     void StoreTrajectories(G4TrajectoryContainer*);
     void StoreHits(G4HCofThisEvent*);
     void StoreIonizationHits(G4VHitsCollection*);
     void StorePmtHits(G4VHitsCollection*);
     void StoreSteps();
+    void StoreSensorPositions();
+    /// Report the time spent storing the event and the output size
+    /// to the run telemetry
+    void ReportTelemetry(G4double seconds);
 
     void SaveConfigurationInfo(G4String history);
 
@@ -91,11 +116,25 @@ namespace nexus {
     G4int nevt_; ///< Event ID
     G4int start_id_; ///< ID for the first event in file
     G4bool first_evt_; ///< true only for the first event of the run
+    G4bool sns_pos_stored_; ///< true once the registered sensors are written
 
     HDF5Writer* h5writer_;  ///< Event writer to hdf5 file
 
+    ResponseLibrary* library_; ///< Library where sensor responses are stored
+    ResponseLibrary* overlay_; ///< Library of responses added to the events
+    G4double overlay_mean_;    ///< Mean number of library entries per event
+    G4double overlay_window_;  ///< Maximum time shift of library entries
+
+    // Thinning of the particles table. Primaries, particles above the
+    // energy threshold or in the truth volumes and all their ancestors
+    // are kept; hits of dropped particles go to their nearest kept ancestor
+    // (or to the first primary if an ancestor has no trajectory).
+    G4double truth_min_energy_; ///< Kinetic energy above which particles are kept
+    std::set<G4String> truth_volumes_; ///< Volumes whose particles are kept
+    std::unordered_map<G4int, G4int> truth_map_; ///< Track ID -> stored particle ID
+
     std::map<G4int, std::vector<G4int>* > hit_map_;
-    std::vector<G4int> sns_posvec_;
+    std::unordered_set<G4int> sns_posvec_; ///< unregistered sensors written
 
     std::map<G4String, G4double> sensdet_bin_;
   };
@@ -5,6 +5,7 @@
 //#include <map>
 #include <G4String.hh>
 #include <vector>
+#include <map>
 
 
 class PersistencyManagerBase: public G4VPersistencyManager
@@ -20,6 +21,20 @@ class PersistencyManagerBase: public G4VPersistencyManager
      inline void SetMacros(G4String init, std::vector<G4String> mcrs, std::vector<G4String> delayed)
          {init_macro_ = init; macros_ = mcrs; delayed_macros_ = delayed;}
 
+     /// Entries of the run configuration table set by other
+     /// parts of the simulation (e.g., generators)
+     std::map<G4String, G4String> run_info_;
+
+     inline void SetRunInfo(const G4String& key, const G4String& value)
+         {run_info_[key] = value;}
+
+     /// If true, events are stored with the ID of the Geant4 event
+     /// (e.g., when they are seeded individually) instead of
+     /// consecutive IDs, so that they can be reproduced
+     G4bool use_event_id_ = false;
+
+     inline void UseEventID(G4bool use) {use_event_id_ = use;}
+
 
   };
 
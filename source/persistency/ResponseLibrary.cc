@@ -0,0 +1,352 @@
+// ----------------------------------------------------------------------------
+// nexus | ResponseLibrary.cc
+//
+// Library of sensor responses. The waveforms recorded by the photosensors
+// in simulated events are stored in an indexed HDF5 file, from which they
+// can be sampled, shifted in time and added to the sensor hits of other
+// events (e.g., to study pile-up without tracking any optical photon).
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "ResponseLibrary.h"
+
+#include "hdf5_functions.h"
+#include "PmtHit.h"
+#include "SensorRegistry.h"
+
+#include <G4HCofThisEvent.hh>
+#include <G4Poisson.hh>
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <cstring>
+
+using namespace nexus;
+
+
+namespace {
+
+  typedef struct{
+    int32_t event_id;
+    uint64_t first_row;
+    uint32_t nrows;
+  } lib_index_t;
+
+  typedef struct{
+    unsigned int sensor_id;
+    char sensdet[STRLEN];
+    float x;
+    float y;
+    float z;
+    float bin_size;
+  } lib_sensor_t;
+
+  /// Appends n rows to a table with unlimited dimension
+  void appendRows(hid_t dataset, hid_t memtype, const void* data,
+                  hsize_t first, hsize_t n)
+  {
+    if (n == 0) return;
+
+    hsize_t dims[1] = {n};
+    hid_t memspace = H5Screate_simple(1, dims, NULL);
+
+    dims[0] = first + n;
+    H5Dset_extent(dataset, dims);
+
+    hid_t file_space = H5Dget_space(dataset);
+    hsize_t start[1] = {first};
+    hsize_t count[1] = {n};
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+    H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, data);
+    H5Sclose(file_space);
+    H5Sclose(memspace);
+  }
+
+  /// Reads n rows of a table starting at row first
+  void readRows(hid_t dataset, hid_t memtype, void* data,
+                hsize_t first, hsize_t n)
+  {
+    if (n == 0) return;
+
+    hsize_t dims[1] = {n};
+    hid_t memspace = H5Screate_simple(1, dims, NULL);
+
+    hid_t file_space = H5Dget_space(dataset);
+    hsize_t start[1] = {first};
+    hsize_t count[1] = {n};
+    H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+    H5Dread(dataset, memtype, memspace, file_space, H5P_DEFAULT, data);
+    H5Sclose(file_space);
+    H5Sclose(memspace);
+  }
+
+  /// Number of rows of a table
+  hsize_t numberOfRows(hid_t dataset)
+  {
+    hid_t file_space = H5Dget_space(dataset);
+    hsize_t dims[1] = {0};
+    H5Sget_simple_extent_dims(file_space, dims, NULL);
+    H5Sclose(file_space);
+    return dims[0];
+  }
+
+} // end anonymous namespace
+
+
+
+ResponseLibrary::ResponseLibrary():
+  file_(-1), index_table_(-1), response_table_(-1), sensor_table_(-1),
+  index_type_(-1), response_type_(-1), sensor_type_(-1),
+  writable_(false), nrows_(0)
+{
+  index_type_ = H5Tcreate(H5T_COMPOUND, sizeof(lib_index_t));
+  H5Tinsert(index_type_, "event_id", HOFFSET(lib_index_t, event_id), H5T_NATIVE_INT32);
+  H5Tinsert(index_type_, "first_row", HOFFSET(lib_index_t, first_row), H5T_NATIVE_UINT64);
+  H5Tinsert(index_type_, "nrows", HOFFSET(lib_index_t, nrows), H5T_NATIVE_UINT32);
+
+  response_type_ = H5Tcreate(H5T_COMPOUND, sizeof(Sample));
+  H5Tinsert(response_type_, "sensor_id", HOFFSET(Sample, sensor_id), H5T_NATIVE_UINT);
+  H5Tinsert(response_type_, "time", HOFFSET(Sample, time), H5T_NATIVE_FLOAT);
+  H5Tinsert(response_type_, "charge", HOFFSET(Sample, charge), H5T_NATIVE_UINT);
+
+  hid_t strtype = H5Tcopy(H5T_C_S1);
+  H5Tset_size(strtype, STRLEN);
+
+  sensor_type_ = H5Tcreate(H5T_COMPOUND, sizeof(lib_sensor_t));
+  H5Tinsert(sensor_type_, "sensor_id", HOFFSET(lib_sensor_t, sensor_id), H5T_NATIVE_UINT);
+  H5Tinsert(sensor_type_, "sensdet", HOFFSET(lib_sensor_t, sensdet), strtype);
+  H5Tinsert(sensor_type_, "x", HOFFSET(lib_sensor_t, x), H5T_NATIVE_FLOAT);
+  H5Tinsert(sensor_type_, "y", HOFFSET(lib_sensor_t, y), H5T_NATIVE_FLOAT);
+  H5Tinsert(sensor_type_, "z", HOFFSET(lib_sensor_t, z), H5T_NATIVE_FLOAT);
+  H5Tinsert(sensor_type_, "bin_size", HOFFSET(lib_sensor_t, bin_size), H5T_NATIVE_FLOAT);
+  H5Tclose(strtype);
+}
+
+
+
+ResponseLibrary::~ResponseLibrary()
+{
+  Close();
+  H5Tclose(index_type_);
+  H5Tclose(response_type_);
+  H5Tclose(sensor_type_);
+}
+
+
+
+void ResponseLibrary::Create(const G4String& filename)
+{
+  Close();
+
+  file_ = H5Fcreate(filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if (file_ < 0) {
+    G4Exception("[ResponseLibrary]", "Create()", FatalException,
+                ("Cannot create response library " + filename).c_str());
+  }
+
+  std::string group_name = "/library";
+  hid_t group = createGroup(file_, group_name);
+
+  std::string index_name    = "index";
+  std::string response_name = "responses";
+  std::string sensor_name   = "sensors";
+  index_table_    = createTable(group, index_name,    index_type_);
+  response_table_ = createTable(group, response_name, response_type_);
+  sensor_table_   = createTable(group, sensor_name,   sensor_type_);
+  H5Gclose(group);
+
+  writable_ = true;
+}
+
+
+
+void ResponseLibrary::Open(const G4String& filename)
+{
+  Close();
+
+  file_ = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if (file_ >= 0) {
+    index_table_    = H5Dopen(file_, "/library/index",     H5P_DEFAULT);
+    response_table_ = H5Dopen(file_, "/library/responses", H5P_DEFAULT);
+    sensor_table_   = H5Dopen(file_, "/library/sensors",   H5P_DEFAULT);
+  }
+  if (file_ < 0 || index_table_ < 0 || response_table_ < 0 || sensor_table_ < 0) {
+    G4Exception("[ResponseLibrary]", "Open()", FatalException,
+                (filename + " is not a valid response library.").c_str());
+  }
+
+  // The index and the sensors are kept in memory,
+  // while the waveforms are read entry by entry
+  std::vector<lib_index_t> index(numberOfRows(index_table_));
+  readRows(index_table_, index_type_, index.data(), 0, index.size());
+  for (const lib_index_t& entry: index)
+    index_.push_back(std::make_pair(entry.first_row, entry.nrows));
+
+  std::vector<lib_sensor_t> sensors(numberOfRows(sensor_table_));
+  readRows(sensor_table_, sensor_type_, sensors.data(), 0, sensors.size());
+  for (const lib_sensor_t& sns: sensors) {
+    Sensor& sensor = sensors_[sns.sensor_id];
+    sensor.sensdet  = sns.sensdet;
+    sensor.position = G4ThreeVector(sns.x, sns.y, sns.z);
+    sensor.bin_size = sns.bin_size * ns;
+  }
+
+  nrows_ = numberOfRows(response_table_);
+
+  if (index_.empty()) {
+    G4Exception("[ResponseLibrary]", "Open()", FatalException,
+                ("Response library " + filename + " has no entries.").c_str());
+  }
+
+  writable_ = false;
+}
+
+
+
+void ResponseLibrary::Close()
+{
+  if (file_ < 0) return;
+
+  H5Dclose(index_table_);
+  H5Dclose(response_table_);
+  H5Dclose(sensor_table_);
+  H5Fclose(file_);
+
+  file_ = index_table_ = response_table_ = sensor_table_ = -1;
+  index_.clear();
+  sensors_.clear();
+  nrows_ = 0;
+}
+
+
+
+void ResponseLibrary::Write(G4int event_id, G4HCofThisEvent* hce)
+{
+  if (!writable_ || !hce) return;
+
+  std::vector<Sample> samples;
+  std::vector<lib_sensor_t> new_sensors;
+
+  for (G4int i=0; i<hce->GetNumberOfCollections(); ++i) {
+    PmtHitsCollection* hits = dynamic_cast<PmtHitsCollection*>(hce->GetHC(i));
+    if (!hits) continue;
+
+    for (size_t j=0; j<hits->entries(); ++j) {
+      PmtHit* hit = (*hits)[j];
+
+      const std::map<G4double, G4int>& wvfm = hit->GetHistogram();
+      for (auto it = wvfm.begin(); it != wvfm.end(); ++it) {
+        Sample sample = {(unsigned int)hit->GetPmtID(), (float)(it->first/ns),
+                         (unsigned int)it->second};
+        samples.push_back(sample);
+      }
+
+      if (sensors_.count(hit->GetPmtID())) continue;
+
+      Sensor& sensor = sensors_[hit->GetPmtID()];
+      sensor.sensdet  = hits->GetSDname();
+      sensor.position = hit->GetPosition();
+      sensor.bin_size = hit->GetBinSize();
+
+      lib_sensor_t sns;
+      memset(&sns, 0, sizeof(sns));
+      sns.sensor_id = hit->GetPmtID();
+      strncpy(sns.sensdet, sensor.sensdet.c_str(), STRLEN-1);
+      sns.x = sensor.position.x();
+      sns.y = sensor.position.y();
+      sns.z = sensor.position.z();
+      sns.bin_size = sensor.bin_size / ns;
+      new_sensors.push_back(sns);
+    }
+  }
+
+  appendRows(sensor_table_, sensor_type_, new_sensors.data(),
+             sensors_.size() - new_sensors.size(), new_sensors.size());
+
+  appendRows(response_table_, response_type_, samples.data(),
+             nrows_, samples.size());
+
+  lib_index_t entry = {event_id, nrows_, (uint32_t)samples.size()};
+  appendRows(index_table_, index_type_, &entry, index_.size(), 1);
+
+  index_.push_back(std::make_pair(nrows_, (unsigned int)samples.size()));
+  nrows_ += samples.size();
+}
+
+
+
+void ResponseLibrary::ReadEntry(size_t entry, std::vector<Sample>& samples)
+{
+  samples.resize(index_[entry].second);
+  readRows(response_table_, response_type_, samples.data(),
+           index_[entry].first, index_[entry].second);
+}
+
+
+
+G4int ResponseLibrary::Overlay(G4HCofThisEvent* hce, G4double mean, G4double window)
+{
+  if (writable_ || index_.empty() || !hce) return 0;
+
+  G4int n = G4Poisson(mean);
+  if (n == 0) return 0;
+
+  // Sensor hits and collections of the event
+  std::map<G4String, PmtHitsCollection*> collections;
+  std::map<G4int, PmtHit*> hits_by_id;
+
+  for (G4int i=0; i<hce->GetNumberOfCollections(); ++i) {
+    PmtHitsCollection* hits = dynamic_cast<PmtHitsCollection*>(hce->GetHC(i));
+    if (!hits) continue;
+    collections[hits->GetSDname()] = hits;
+    for (size_t j=0; j<hits->entries(); ++j)
+      hits_by_id[(*hits)[j]->GetPmtID()] = (*hits)[j];
+  }
+
+  std::vector<Sample> samples;
+
+  for (G4int k=0; k<n; ++k) {
+
+    ReadEntry(G4RandFlat::shootInt((long)index_.size()), samples);
+    G4double shift = G4UniformRand() * window;
+
+    for (const Sample& sample: samples) {
+
+      PmtHit* hit = 0;
+      auto hit_it = hits_by_id.find(sample.sensor_id);
+
+      if (hit_it != hits_by_id.end()) {
+        hit = hit_it->second;
+      }
+      else {
+        const Sensor& sensor = sensors_[sample.sensor_id];
+        auto hc_it = collections.find(sensor.sensdet);
+        if (hc_it == collections.end()) {
+          G4Exception("[ResponseLibrary]", "Overlay()", FatalException,
+                      ("Sensitive detector " + sensor.sensdet +
+                       " of the response library not found.").c_str());
+        }
+
+        // Sensors in the registry take the position and
+        // binning of the current geometry
+        hit = new PmtHit();
+        hit->SetPmtID(sample.sensor_id);
+        G4int slot = SensorRegistry::GetSlot(sample.sensor_id);
+        if (slot >= 0) {
+          hit->SetBinSize(SensorRegistry::GetSensor(slot).binning);
+          hit->SetPosition(SensorRegistry::GetSensor(slot).position);
+        } else {
+          hit->SetBinSize(sensor.bin_size);
+          hit->SetPosition(sensor.position);
+        }
+        hc_it->second->insert(hit);
+        hits_by_id[sample.sensor_id] = hit;
+      }
+
+      hit->Fill(sample.time * ns + shift, sample.charge);
+    }
+  }
+
+  return n;
+}
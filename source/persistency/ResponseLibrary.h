@@ -0,0 +1,91 @@
+// ----------------------------------------------------------------------------
+// nexus | ResponseLibrary.h
+//
+// Library of sensor responses. The waveforms recorded by the photosensors
+// in simulated events are stored in an indexed HDF5 file, from which they
+// can be sampled, shifted in time and added to the sensor hits of other
+// events (e.g., to study pile-up without tracking any optical photon).
+//
+// The library file has three tables in the group /library:
+//   - index:     event_id, first_row, nrows (one row per library entry)
+//   - responses: sensor_id, time, charge (sparse waveforms of all entries)
+//   - sensors:   sensor_id, sensdet, x, y, z, bin_size
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef RESPONSE_LIBRARY_H
+#define RESPONSE_LIBRARY_H
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <hdf5.h>
+#include <vector>
+#include <map>
+
+class G4HCofThisEvent;
+
+
+namespace nexus {
+
+  class ResponseLibrary
+  {
+  public:
+    /// Constructor
+    ResponseLibrary();
+    /// Destructor (closes the file, if open)
+    ~ResponseLibrary();
+
+    /// Creates a new library file to be filled with Write
+    void Create(const G4String& filename);
+    /// Opens an existing library file to be read with Overlay
+    void Open(const G4String& filename);
+    /// Closes the library file
+    void Close();
+
+    /// Adds the waveforms of the sensor hits of an event as a new entry
+    void Write(G4int event_id, G4HCofThisEvent*);
+
+    /// Adds to the sensor hits of an event a Poisson-distributed number
+    /// (with the given mean) of random library entries, each one delayed
+    /// by a time uniformly distributed in [0, window].
+    /// Returns the number of entries added.
+    G4int Overlay(G4HCofThisEvent*, G4double mean, G4double window);
+
+    /// Returns the number of entries of the library
+    size_t GetNumberOfEntries() const;
+
+  private:
+    struct Sample {
+      unsigned int sensor_id;
+      float time;
+      unsigned int charge;
+    };
+
+    struct Sensor {
+      G4String sensdet;
+      G4ThreeVector position;
+      G4double bin_size;
+    };
+
+    void ReadEntry(size_t entry, std::vector<Sample>&);
+
+  private:
+    hid_t file_;
+    hid_t index_table_, response_table_, sensor_table_;
+    hid_t index_type_, response_type_, sensor_type_;
+    G4bool writable_;
+
+    /// First row and number of rows of each entry
+    std::vector<std::pair<unsigned long long, unsigned int> > index_;
+    std::map<unsigned int, Sensor> sensors_;
+    unsigned long long nrows_; ///< Rows of the responses table
+  };
+
+  inline size_t ResponseLibrary::GetNumberOfEntries() const
+  { return index_.size(); }
+
+} // end namespace nexus
+
+#endif
@@ -88,6 +88,7 @@ hsize_t createParticleInfoType()
   H5Tinsert (memtype, "length", HOFFSET (particle_info_t, length), H5T_NATIVE_FLOAT);
   H5Tinsert (memtype, "creator_proc", HOFFSET (particle_info_t, creator_proc), proc_strtype);
   H5Tinsert (memtype, "final_proc", HOFFSET (particle_info_t, final_proc), proc_strtype);
+  H5Tinsert (memtype, "weight", HOFFSET (particle_info_t, weight), H5T_NATIVE_FLOAT);
   return memtype;
 }
 
@@ -134,6 +135,23 @@ hsize_t createStepType()
   return memtype;
 }
 
+
+hsize_t createEventIndexType()
+{
+  //Create compound datatype for the table
+  hsize_t memtype = H5Tcreate (H5T_COMPOUND, sizeof(event_index_t));
+  H5Tinsert (memtype, "event_id"          , HOFFSET(event_index_t, event_id          ), H5T_NATIVE_INT32 );
+  H5Tinsert (memtype, "first_sns_response", HOFFSET(event_index_t, first_sns_response), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "n_sns_response"    , HOFFSET(event_index_t, n_sns_response    ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "first_hit"         , HOFFSET(event_index_t, first_hit         ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "n_hits"            , HOFFSET(event_index_t, n_hits            ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "first_particle"    , HOFFSET(event_index_t, first_particle    ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "n_particles"       , HOFFSET(event_index_t, n_particles       ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "first_step"        , HOFFSET(event_index_t, first_step        ), H5T_NATIVE_UINT64);
+  H5Tinsert (memtype, "n_steps"           , HOFFSET(event_index_t, n_steps           ), H5T_NATIVE_UINT64);
+  return memtype;
+}
+
 hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype)
 {
   //Create 1D dataspace (evt number). First dimension is unlimited (initially 0)
@@ -292,3 +310,23 @@ void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter)
   H5Sclose(file_space);
   H5Sclose(memspace);
 }
+
+void writeEventIndex(event_index_t* index, hid_t dataset, hid_t memtype, hsize_t counter)
+{
+  hid_t memspace, file_space;
+
+  const hsize_t n_dims = 1;
+  hsize_t dims[n_dims] = {1};
+  memspace = H5Screate_simple(n_dims, dims, NULL);
+
+  dims[0] = counter+1;
+  H5Dset_extent(dataset, dims);
+
+  file_space = H5Dget_space(dataset);
+  hsize_t start[1] = {counter};
+  hsize_t count[1] = {1};
+  H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+  H5Dwrite(dataset, memtype, memspace, file_space, H5P_DEFAULT, index);
+  H5Sclose(file_space);
+  H5Sclose(memspace);
+}
@@ -65,6 +65,7 @@
 	float length;
         char creator_proc[STRLEN];
 	char final_proc[STRLEN];
+	float weight;
   } particle_info_t;
 
   typedef struct{
@@ -91,12 +92,25 @@
     float     final_z;
   } step_info_t;
 
+  typedef struct{
+    int32_t  event_id;
+    uint64_t first_sns_response;
+    uint64_t n_sns_response;
+    uint64_t first_hit;
+    uint64_t n_hits;
+    uint64_t first_particle;
+    uint64_t n_particles;
+    uint64_t first_step;
+    uint64_t n_steps;
+  } event_index_t;
+
   hsize_t createRunType();
   hsize_t createSensorDataType();
   hsize_t createHitInfoType();
   hsize_t createParticleInfoType();
   hsize_t createSensorPosType();
   hsize_t createStepType();
+  hsize_t createEventIndexType();
 
   hid_t createTable(hid_t group, std::string& table_name, hsize_t memtype);
   hid_t createGroup(hid_t file, std::string& groupName);
@@ -107,6 +121,7 @@
   void writeParticle(particle_info_t* particleInfo, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeSnsPos(sns_pos_t* snsPos, hid_t dataset, hid_t memtype, hsize_t counter);
   void writeStep(step_info_t* step, hid_t dataset, hid_t memtype, hsize_t counter);
+  void writeEventIndex(event_index_t* index, hid_t dataset, hid_t memtype, hsize_t counter);
 
 
 #endif
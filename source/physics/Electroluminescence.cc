@@ -10,6 +10,7 @@
 
 #include "IonizationElectron.h"
 #include "BaseDriftField.h"
+#include "PhotonThinning.h"
 
 #include <G4MaterialPropertiesTable.hh>
 #include <G4PhysicsOrderedFreeVector.hh>
@@ -85,8 +86,9 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   if (yield <= 0.)
     return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-  // Generate a random number of photons around mean 'yield'
-  G4double mean = yield * step_length;
+  // Generate a random number of photons around mean 'yield',
+  // reduced by the photon thinning, if any
+  G4double mean = yield * step_length * PhotonThinning::GetSurvivalFactor();
 
   G4int num_photons;
 
@@ -99,7 +101,7 @@ Electroluminescence::PostStepDoIt(const G4Track& track, const G4Step& step)
   }
 
   if (table_generation_)
-    num_photons = photons_per_point_;
+    num_photons = PhotonThinning::Thin(photons_per_point_);
 
   ParticleChange_->SetNumberOfSecondaries(num_photons);
 
@@ -0,0 +1,173 @@
+// ----------------------------------------------------------------------------
+// nexus | FiberTransport.cc
+//
+// Fast simulation model of the light transport along a barrel of
+// wavelength-shifting fibers. Photons trapped by total internal reflection
+// in the fiber core are moved in a single step to the end of the fiber
+// they travel to, instead of following every reflection, taking into
+// account the attenuation and the transit time along the fiber.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "FiberTransport.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4Region.hh>
+#include <G4LogicalVolume.hh>
+#include <G4Material.hh>
+#include <G4Tubs.hh>
+#include <G4FastTrack.hh>
+#include <G4FastStep.hh>
+#include <Randomize.hh>
+
+#include "CLHEP/Units/SystemOfUnits.h"
+
+#include <cmath>
+
+
+namespace nexus {
+
+  /// Distance to the end face of the fiber where photons are left,
+  /// so that Geant4 transports them across it into the sensors
+  const G4double kEndGap = 1.*CLHEP::micrometer;
+
+
+  FiberTransport::FiberTransport(G4Region* region, const G4Material* cladding):
+    G4VFastSimulationModel("FiberTransport", region),
+    core_(0), cladding_(cladding)
+  {
+    G4LogicalVolume* lv = *(region->GetRootLogicalVolumeIterator());
+    const G4Tubs* tubs = dynamic_cast<const G4Tubs*>(lv->GetSolid());
+    if (!tubs)
+      G4Exception("[FiberTransport]", "FiberTransport()", FatalException,
+                  "The fiber core must be a G4Tubs.");
+
+    core_        = lv->GetMaterial();
+    rmin_        = tubs->GetInnerRadius();
+    rmax_        = tubs->GetOuterRadius();
+    half_length_ = tubs->GetZHalfLength();
+  }
+
+
+
+  FiberTransport::~FiberTransport()
+  {
+  }
+
+
+
+  G4bool FiberTransport::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (pdef == *G4OpticalPhoton::Definition());
+  }
+
+
+
+  G4bool FiberTransport::ModelTrigger(const G4FastTrack& ftrack)
+  {
+    G4ThreeVector position  = ftrack.GetPrimaryTrackLocalPosition();
+    G4ThreeVector direction = ftrack.GetPrimaryTrackLocalDirection();
+
+    if (direction.z() == 0. || position.perp() == 0.) return false;
+
+    // Photons already at the end of the fiber are left to Geant4
+    G4double z_end = (direction.z() > 0.) ? half_length_ : -half_length_;
+    if (std::abs(z_end - position.z()) <= 2.*kEndGap) return false;
+
+    // The core is a thin cylindrical shell, locally treated as a slab.
+    // The angle of incidence on its walls is kept along the fiber, and
+    // the photon is trapped if it is above the critical angle of the
+    // interface with the cladding. Photons from outside the core can
+    // never be trapped; these are those re-emitted (or scattered) in it.
+    G4double energy = ftrack.GetPrimaryTrack()->GetKineticEnergy();
+    G4double n_core = RefractiveIndex(core_, energy);
+    G4double n_clad = RefractiveIndex(cladding_, energy);
+    if (n_core <= n_clad) return false;
+
+    G4double dir_r = direction.x() * position.x()/position.perp() +
+                     direction.y() * position.y()/position.perp();
+
+    return (1. - dir_r*dir_r > (n_clad*n_clad) / (n_core*n_core));
+  }
+
+
+
+  void FiberTransport::DoIt(const G4FastTrack& ftrack, G4FastStep& fstep)
+  {
+    const G4Track* track = ftrack.GetPrimaryTrack();
+
+    G4ThreeVector position  = ftrack.GetPrimaryTrackLocalPosition();
+    G4ThreeVector direction = ftrack.GetPrimaryTrackLocalDirection();
+
+    // Path length to the end of the fiber, which is
+    // not changed by the reflections on the walls
+    G4double z_end = (direction.z() > 0.) ?
+      half_length_ - kEndGap : -half_length_ + kEndGap;
+    G4double length = (z_end - position.z()) / direction.z();
+
+    // Absorption in the core, including the absorption by the wavelength
+    // shifter, whose re-emission is neglected (its emission spectrum is
+    // mostly above its absorption spectrum)
+    G4double energy = track->GetKineticEnergy();
+    G4double inv_abs_length = 0.;
+    G4MaterialPropertiesTable* mpt = core_->GetMaterialPropertiesTable();
+    const char* properties[] = {"ABSLENGTH", "WLSABSLENGTH"};
+    for (auto property: properties) {
+      G4MaterialPropertyVector* abs_length = mpt->GetProperty(property);
+      if (abs_length) inv_abs_length += 1. / abs_length->Value(energy);
+    }
+
+    G4double velocity = track->CalculateVelocityForOpticalPhoton();
+
+    if (inv_abs_length > 0.) {
+      G4double abs_path = -std::log(G4UniformRand()) / inv_abs_length;
+      if (abs_path < length) {
+        fstep.ProposePrimaryTrackPathLength(abs_path);
+        fstep.ProposePrimaryTrackFinalTime(track->GetGlobalTime() + abs_path/velocity);
+        fstep.KillPrimaryTrack();
+        return;
+      }
+    }
+
+    // The photon advances around the barrel according to its tangential
+    // direction, which is kept by the reflections on the walls of the shell
+    G4double rho = position.perp();
+    G4double dir_t = (direction.y() * position.x() -
+                      direction.x() * position.y()) / rho;
+    G4double mid_rad = (rmin_ + rmax_) / 2.;
+    G4double dphi = length * dir_t / mid_rad;
+
+    // It is left in the middle of the shell, just before the end face
+    G4double phi = position.phi() + dphi;
+    G4ThreeVector final_position(mid_rad * std::cos(phi),
+                                 mid_rad * std::sin(phi), z_end);
+
+    G4ThreeVector final_direction = direction;
+    final_direction.rotateZ(dphi);
+    G4ThreeVector final_polarization = ftrack.GetPrimaryTrackLocalPolarization();
+    final_polarization.rotateZ(dphi);
+
+    fstep.ProposePrimaryTrackFinalPosition(final_position);
+    fstep.ProposePrimaryTrackFinalMomentumDirection(final_direction);
+    fstep.ProposePrimaryTrackFinalPolarization(final_polarization);
+    fstep.ProposePrimaryTrackFinalTime(track->GetGlobalTime() + length/velocity);
+    fstep.ProposePrimaryTrackPathLength(length);
+  }
+
+
+
+  G4double FiberTransport::RefractiveIndex(const G4Material* material,
+                                           G4double energy) const
+  {
+    // Materials without optical properties are taken as vacuum
+    G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+    if (!mpt) return 1.;
+
+    G4MaterialPropertyVector* rindex = mpt->GetProperty("RINDEX");
+    if (!rindex) return 1.;
+
+    return rindex->Value(energy);
+  }
+
+} // end namespace nexus
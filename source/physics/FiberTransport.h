@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+// nexus | FiberTransport.h
+//
+// Fast simulation model of the light transport along a barrel of
+// wavelength-shifting fibers. Photons trapped by total internal reflection
+// in the fiber core are moved in a single step to the end of the fiber
+// they travel to, instead of following every reflection, taking into
+// account the attenuation and the transit time along the fiber.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef FIBER_TRANSPORT_H
+#define FIBER_TRANSPORT_H
+
+#include <G4VFastSimulationModel.hh>
+
+class G4Material;
+
+
+namespace nexus {
+
+  class FiberTransport: public G4VFastSimulationModel
+  {
+  public:
+    /// Constructor taking the region of the fiber core, whose root logical
+    /// volume must be a cylindrical shell (G4Tubs) along the z axis, and the
+    /// material surrounding the core (i.e., the inner cladding, if any)
+    FiberTransport(G4Region* region, const G4Material* cladding);
+    /// Destructor
+    ~FiberTransport();
+
+    /// Returns true only for optical photons
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Returns true if the photon is trapped in the core
+    /// and has not reached yet the end of the fiber
+    G4bool ModelTrigger(const G4FastTrack&);
+
+    /// Moves the photon to the end of the fiber, unless it is
+    /// absorbed on its way, in which case it is killed
+    void DoIt(const G4FastTrack&, G4FastStep&);
+
+  private:
+    /// Returns the refractive index of a material at the given energy
+    G4double RefractiveIndex(const G4Material*, G4double energy) const;
+
+  private:
+    const G4Material* core_;
+    const G4Material* cladding_;
+
+    G4double rmin_, rmax_; ///< Radii of the core
+    G4double half_length_; ///< Half length of the core
+  };
+
+} // end namespace nexus
+
+#endif
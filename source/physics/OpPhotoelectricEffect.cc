@@ -46,27 +46,52 @@ namespace nexus {
     return pdef == *G4OpticalPhoton::Definition();
   }
 
+
+
+  void OpPhotoelectricEffect::BuildPhysicsTable(const G4ParticleDefinition&)
+  {
+    const G4MaterialTable* materials = G4Material::GetMaterialTable();
+    G4int num_materials = G4Material::GetNumberOfMaterials();
+
+    work_function_.assign(num_materials, 0.);
+    probability_  .assign(num_materials, 0.);
+
+    for (G4int i=0; i<num_materials; ++i) {
+      G4MaterialPropertiesTable* mpt =
+        (*materials)[i]->GetMaterialPropertiesTable();
+
+      if (!mpt ||
+          !mpt->ConstPropertyExists("WORK_FUNCTION") ||
+          !mpt->ConstPropertyExists("OP_PHOTOELECTRIC_PROBABILITY"))
+        continue;
+
+      G4double work_function = mpt->GetConstProperty("WORK_FUNCTION");
+      G4double probability   = mpt->GetConstProperty("OP_PHOTOELECTRIC_PROBABILITY");
+
+      // A null work function disables the process as well
+      if (!work_function || !probability) continue;
+
+      work_function_[i] = work_function;
+      probability_  [i] = probability;
+    }
+  }
+
+
+
   G4VParticleChange*
   OpPhotoelectricEffect::PostStepDoIt(const G4Track& track, const G4Step& step)
   {
     // Initialize particle change with current track values
     particle_change_->Initialize(track);
 
-    const G4Material* material = track.GetMaterial();
-
-    G4MaterialPropertiesTable* mpt = material->GetMaterialPropertiesTable();
+    G4int index = track.GetMaterial()->GetIndex();
 
-    if (!mpt ||
-        !mpt->ConstPropertyExists("WORK_FUNCTION") ||
-        !mpt->ConstPropertyExists("OP_PHOTOELECTRIC_PROBABILITY"))
+    if (index >= (G4int)probability_.size() || !probability_[index])
       return G4VDiscreteProcess::PostStepDoIt(track, step);
 
     G4double photon_energy = track.GetDynamicParticle()->GetTotalEnergy();
-    G4double work_function = mpt->GetConstProperty("WORK_FUNCTION");
-    G4double probability   = mpt->GetConstProperty("OP_PHOTOELECTRIC_PROBABILITY");
-
-    if (!work_function || !probability)
-      return G4VDiscreteProcess::PostStepDoIt(track, step);
+    G4double work_function = work_function_[index];
+    G4double probability   = probability_[index];
 
     // We have to compare the energy with the work function here because
     // Geant4 doesn't deal with the vector of probabilities correctly.
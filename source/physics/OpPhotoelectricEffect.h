@@ -12,6 +12,7 @@
 
 
 #include <G4VDiscreteProcess.hh>
+#include <vector>
 
 class G4Material;
 
@@ -35,6 +36,10 @@ namespace nexus {
     /// and generates new particles if necessary.
     G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
 
+    /// Caches, per material index, the work function and the
+    /// photoelectric probability used at every step
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+
   private:
 
     /// Returns infinity; i. e. the process does not limit the step,
@@ -52,6 +57,12 @@ namespace nexus {
   private:
     G4ParticleChange* particle_change_;
 
+    /// WORK_FUNCTION of each material, indexed by material index
+    std::vector<G4double> work_function_;
+    /// OP_PHOTOELECTRIC_PROBABILITY of each material, indexed by
+    /// material index. It is zero for materials without photoelectric effect.
+    std::vector<G4double> probability_;
+
   };
 
 } // end namespace nexus
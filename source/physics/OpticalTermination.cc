@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalTermination.cc
+//
+// Termination policies for optical photons: a maximum number of boundary
+// reflections, a maximum path length, a maximum lifetime and a set of volumes
+// where photons are killed as soon as they enter. The number of photons
+// removed by each policy is counted over the run.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "OpticalTermination.h"
+
+#include "PersistencyManagerBase.h"
+
+#include <G4OpticalPhoton.hh>
+#include <G4OpBoundaryProcess.hh>
+#include <G4ProcessManager.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4VPersistencyManager.hh>
+
+
+G4bool nexus::OpticalTermination::enabled_ = false;
+G4long nexus::OpticalTermination::killed_[] = {0, 0, 0, 0};
+
+
+namespace nexus {
+
+
+  OpticalTermination::OpticalTermination(G4int max_reflections,
+                                         G4double max_length,
+                                         G4double max_time,
+                                         const std::vector<G4String>& volumes,
+                                         const G4String& process_name,
+                                         G4ProcessType type):
+    G4VDiscreteProcess(process_name, type), ParticleChange_(0), boundary_(0),
+    max_reflections_(max_reflections), max_length_(max_length),
+    max_time_(max_time), reflections_(0)
+  {
+    ParticleChange_ = new G4ParticleChange();
+    pParticleChange = ParticleChange_;
+
+    // The geometry is already constructed when
+    // the physics processes are created
+    G4LogicalVolumeStore* lvstore = G4LogicalVolumeStore::GetInstance();
+    for (auto& name: volumes) {
+      G4LogicalVolume* lv = lvstore->GetVolume(name, false);
+      if (!lv)
+        G4Exception("[OpticalTermination]", "OpticalTermination()", FatalException,
+                    ("Unknown logical volume " + name).c_str());
+      volumes_.insert(lv);
+    }
+
+    enabled_ = true;
+  }
+
+
+
+  OpticalTermination::~OpticalTermination()
+  {
+    delete ParticleChange_;
+  }
+
+
+
+  G4bool OpticalTermination::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    return (pdef == *G4OpticalPhoton::Definition());
+  }
+
+
+
+  G4VParticleChange*
+  OpticalTermination::PostStepDoIt(const G4Track& track, const G4Step& step)
+  {
+    ParticleChange_->Initialize(track);
+
+    if (track.GetCurrentStepNumber() == 1) reflections_ = 0;
+
+    // Nothing to do if the photon has already been
+    // absorbed or detected in this step
+    if (track.GetTrackStatus() == fStopAndKill) return ParticleChange_;
+
+    // The boundary process has already been invoked for this step,
+    // since the physics of optical photons is constructed before nexus'
+    const G4StepPoint* post = step.GetPostStepPoint();
+    G4bool reflected = post->GetStepStatus() == fGeomBoundary && IsReflection();
+    if (reflected) ++reflections_;
+
+    Policy policy = NPOLICIES;
+
+    // At a boundary, the post-step volume is the one on the far side
+    // even if the photon was reflected, in which case it didn't enter it
+    const G4VPhysicalVolume* pv = post->GetPhysicalVolume();
+    if (!reflected && pv && volumes_.count(pv->GetLogicalVolume()))
+      policy = VOLUME;
+    else if (max_reflections_ > 0 && reflections_ > max_reflections_)
+      policy = REFLECTIONS;
+    else if (max_length_ > 0. && track.GetTrackLength() > max_length_)
+      policy = LENGTH;
+    else if (max_time_ > 0. && track.GetLocalTime() > max_time_)
+      policy = TIME;
+
+    if (policy != NPOLICIES) {
+      ++killed_[policy];
+      ParticleChange_->ProposeTrackStatus(fStopAndKill);
+    }
+
+    return ParticleChange_;
+  }
+
+
+
+  G4bool OpticalTermination::IsReflection()
+  {
+    // Retrieve the pointer to the optical boundary process, if it has
+    // not been done yet (i.e., if the pointer is not defined)
+    if (!boundary_) {
+      G4ProcessVector* pv =
+        G4OpticalPhoton::Definition()->GetProcessManager()->GetProcessList();
+      for (size_t i=0; i<pv->size(); i++) {
+        if ((*pv)[i]->GetProcessName() == "OpBoundary") {
+          boundary_ = (G4OpBoundaryProcess*) (*pv)[i];
+          break;
+        }
+      }
+      if (!boundary_) return false;
+    }
+
+    switch (boundary_->GetStatus()) {
+    case FresnelReflection:
+    case TotalInternalReflection:
+    case LambertianReflection:
+    case LobeReflection:
+    case SpikeReflection:
+    case BackScattering:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+
+
+  void OpticalTermination::ResetCounters()
+  {
+    for (G4int i=0; i<NPOLICIES; ++i) killed_[i] = 0;
+  }
+
+
+
+  void OpticalTermination::ReportCounters()
+  {
+    if (!enabled_) return;
+
+    const char* names[NPOLICIES] = {"volume", "reflections", "length", "time"};
+
+    G4cout << "### Optical photons killed by termination policies:";
+    for (G4int i=0; i<NPOLICIES; ++i)
+      G4cout << " " << names[i] << " " << killed_[i];
+    G4cout << G4endl;
+
+    PersistencyManagerBase* pm = dynamic_cast<PersistencyManagerBase*>
+      (G4VPersistencyManager::GetPersistencyManager());
+    if (!pm) return;
+
+    for (G4int i=0; i<NPOLICIES; ++i)
+      pm->SetRunInfo(G4String("optical_killed_") + names[i],
+                     std::to_string(killed_[i]));
+  }
+
+
+
+  G4double OpticalTermination::GetMeanFreePath(const G4Track&,
+    G4double, G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+} // end namespace nexus
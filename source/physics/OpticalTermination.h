@@ -0,0 +1,78 @@
+// ----------------------------------------------------------------------------
+// nexus | OpticalTermination.h
+//
+// Termination policies for optical photons: a maximum number of boundary
+// reflections, a maximum path length, a maximum lifetime and a set of volumes
+// where photons are killed as soon as they enter. The number of photons
+// removed by each policy is counted over the run.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef OPTICAL_TERMINATION_H
+#define OPTICAL_TERMINATION_H
+
+#include <G4VDiscreteProcess.hh>
+
+#include <vector>
+#include <set>
+
+class G4LogicalVolume;
+class G4OpBoundaryProcess;
+
+
+namespace nexus {
+
+  class OpticalTermination: public G4VDiscreteProcess
+  {
+  public:
+    /// Constructor taking the limits of the policies (0 disables
+    /// them) and the names of the logical volumes where photons are killed
+    OpticalTermination(G4int max_reflections, G4double max_length,
+                       G4double max_time, const std::vector<G4String>& volumes,
+                       const G4String& process_name="OpticalTermination",
+                       G4ProcessType type = fUserDefined);
+    /// Destructor
+    ~OpticalTermination();
+
+    /// Returns true only for optical photons
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Kills the photon if any of the policies applies
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    /// Reset the counters of killed photons (invoked at the start of run)
+    static void ResetCounters();
+    /// Print the counters of killed photons and add them to the run
+    /// information of the output file (invoked at the end of run)
+    static void ReportCounters();
+
+  private:
+    /// Returns infinity; i. e. the process does not limit the step,
+    /// but sets the 'StronglyForced' condition for the PostStepDoIt
+    /// to be invoked at every step
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+    /// Returns true if the photon has been reflected at the end of the step
+    G4bool IsReflection();
+
+  private:
+    enum Policy { VOLUME, REFLECTIONS, LENGTH, TIME, NPOLICIES };
+
+    G4ParticleChange* ParticleChange_;
+    G4OpBoundaryProcess* boundary_;
+
+    G4int max_reflections_;
+    G4double max_length_;
+    G4double max_time_;
+    std::set<const G4LogicalVolume*> volumes_;
+
+    G4int reflections_; ///< Reflections of the current photon
+
+    static G4bool enabled_;
+    static G4long killed_[NPOLICIES]; ///< Photons killed by each policy
+  };
+
+} // end namespace nexus
+
+#endif
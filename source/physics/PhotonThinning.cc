@@ -0,0 +1,76 @@
+// ----------------------------------------------------------------------------
+// nexus | PhotonThinning.cc
+//
+// Thinning of the optical photons produced in the detector. Only a fraction
+// (the survival factor) of the EL and scintillation photons is generated,
+// and the detection efficiencies of the photosensors are divided by the
+// same factor, so that the statistics of detected photons is unchanged.
+// Thinning is refused if any efficiency exceeds the survival factor.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "PhotonThinning.h"
+
+#include <G4MaterialPropertiesTable.hh>
+#include <Randomize.hh>
+
+using namespace nexus;
+
+
+G4double PhotonThinning::survival_ = 1.;
+std::set<const G4MaterialPropertiesTable*> PhotonThinning::scaled_;
+
+
+
+void PhotonThinning::SetSurvivalFactor(G4double survival)
+{
+  if (survival <= 0. || survival > 1.) {
+    G4Exception("[PhotonThinning]", "SetSurvivalFactor()", FatalException,
+                "The photon survival factor must be in (0,1].");
+  }
+
+  if (!scaled_.empty() && survival != survival_) {
+    G4Exception("[PhotonThinning]", "SetSurvivalFactor()", FatalException,
+                "The photon survival factor cannot be changed after "
+                "the photosensors have been constructed.");
+  }
+
+  survival_ = survival;
+}
+
+
+
+G4int PhotonThinning::Thin(G4int n)
+{
+  if (!IsEnabled() || n <= 0) return n;
+  return G4int(CLHEP::RandBinomial::shoot(n, survival_));
+}
+
+
+
+void PhotonThinning::ScaleEfficiency(G4MaterialPropertiesTable* mpt,
+                                     const G4String& sensor)
+{
+  if (!IsEnabled() || !mpt) return;
+
+  // The same table may be shared by several sensors
+  if (!scaled_.insert(mpt).second) return;
+
+  G4MaterialPropertyVector* efficiency = mpt->GetProperty("EFFICIENCY");
+  if (!efficiency) return;
+
+  // An efficiency above the survival factor would be clipped at 1,
+  // removing detected photons, so thinning is refused altogether
+  for (size_t i=0; i<efficiency->GetVectorLength(); ++i) {
+    if ((*efficiency)[i] > survival_) {
+      G4String msg = "The efficiency of " + sensor +
+        " exceeds the photon survival factor. Use a survival factor" +
+        " not lower than the maximum efficiency of the sensors.";
+      G4Exception("[PhotonThinning]", "ScaleEfficiency()", FatalException, msg.c_str());
+    }
+  }
+
+  for (size_t i=0; i<efficiency->GetVectorLength(); ++i)
+    efficiency->PutValue(i, (*efficiency)[i] / survival_);
+}
@@ -0,0 +1,62 @@
+// ----------------------------------------------------------------------------
+// nexus | PhotonThinning.h
+//
+// Thinning of the optical photons produced in the detector. Only a fraction
+// (the survival factor) of the EL and scintillation photons is generated,
+// and the detection efficiencies of the photosensors are divided by the
+// same factor, so that the statistics of detected photons is unchanged.
+// Thinning is refused if any efficiency exceeds the survival factor.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef PHOTON_THINNING_H
+#define PHOTON_THINNING_H
+
+#include <globals.hh>
+#include <set>
+
+class G4MaterialPropertiesTable;
+
+
+namespace nexus {
+
+  class PhotonThinning
+  {
+  public:
+    /// Set the fraction of photons that are generated, in (0,1]
+    static void SetSurvivalFactor(G4double);
+    static G4double GetSurvivalFactor();
+
+    /// Returns true if photons are being thinned
+    static G4bool IsEnabled();
+
+    /// Returns how many photons out of n survive the thinning
+    static G4int Thin(G4int n);
+
+    /// Divides the EFFICIENCY property of a photosensor optical
+    /// surface by the survival factor. Each table is scaled only once.
+    /// It is a fatal error if any efficiency exceeds the survival factor.
+    static void ScaleEfficiency(G4MaterialPropertiesTable*, const G4String& sensor);
+
+  private:
+    // Constructors, destructor and assignment op are hidden
+    // so that no instance of the class can be created.
+    PhotonThinning();
+    ~PhotonThinning();
+    PhotonThinning(const PhotonThinning&);
+
+  private:
+    static G4double survival_;
+    static std::set<const G4MaterialPropertiesTable*> scaled_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4double PhotonThinning::GetSurvivalFactor() { return survival_; }
+
+  inline G4bool PhotonThinning::IsEnabled() { return survival_ < 1.; }
+
+} // end namespace nexus
+
+#endif
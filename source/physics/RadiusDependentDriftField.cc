@@ -1,39 +1,469 @@
 // ----------------------------------------------------------------------------
 // nexus | RadiusDependentDriftField.cc
 //
-// Drift field varying with radial coordinate.
+// Drift field varying with radial coordinate. The field is described by a
+// 2D (r,z) field map, from which a table with the end point of the drift
+// line starting at each node of a regular grid is precomputed once. The
+// table is stored in a binary file which is memory-mapped, so that drifting
+// an electron reduces to a bilinear interpolation in the table.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
 
 
 #include "RadiusDependentDriftField.h"
+#include "SegmentPointSampler.h"
+
+#include <Randomize.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <fstream>
+#include <sstream>
+#include <set>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 using namespace nexus;
 
+namespace {
+  const char table_magic[8] = {'N','X','D','R','I','F','T','3'};
 
+  G4bool SameParameter(G4double stored, G4double current)
+  {
+    return std::abs(stored - current) <= 1.e-9 * std::max(1., std::abs(current));
+  }
+}
 
-RadiusDependentDriftField::RadiusDependentDriftField(): BaseDriftField()
+
+
+RadiusDependentDriftField::RadiusDependentDriftField
+(G4double anode_position, G4double cathode_position, G4double max_radius):
+  BaseDriftField(),
+  anode_pos_(anode_position), cathode_pos_(cathode_position),
+  max_radius_(max_radius),
+  drift_velocity_(1. * mm/microsecond), transv_diff_(0.), longit_diff_(0.),
+  light_yield_(0.),
+  map_nr_(0), map_nz_(0),
+  map_rmin_(0.), map_rmax_(0.), map_zmin_(0.), map_zmax_(0.),
+  map_hash_(0),
+  map_addr_(nullptr), map_size_(0), header_(nullptr), table_(nullptr),
+  dr_(0.), dz_(0.)
 {
+  // initialize random generator with dummy values
+  rnd_ = new SegmentPointSampler(G4LorentzVector(0.,0.,0.,-999.),
+                                 G4LorentzVector(0.,0.,0.,-999.));
 }
 
 
 
 RadiusDependentDriftField::~RadiusDependentDriftField()
 {
+  UnmapDriftTable();
+  delete rnd_;
+}
+
+
+
+void RadiusDependentDriftField::LoadDriftTable(const G4String& table_file,
+                                               const G4String& field_map_file)
+{
+  UnmapDriftTable();
+
+  std::ifstream test(table_file, std::ifstream::binary);
+  G4bool exists = test.good();
+  test.close();
+
+  map_hash_ = (field_map_file == "") ? 0 : HashFieldMap(field_map_file);
+
+  if (exists && MapDriftTable(table_file)) return;
+
+  if (field_map_file == "") {
+    G4String msg = exists ?
+      "Drift table " + table_file + " is not valid or was computed with other" +
+      " parameters, and no field map provided to compute it again." :
+      "Drift table " + table_file + " not found and no field map provided to compute it.";
+    G4Exception("[RadiusDependentDriftField]", "LoadDriftTable()",
+                FatalException, msg);
+  }
+
+  if (exists) {
+    G4String msg = "Drift table " + table_file + " is not valid or was computed" +
+      " with other parameters. It will be computed again.";
+    G4Exception("[RadiusDependentDriftField]", "LoadDriftTable()",
+                JustWarning, msg);
+  }
+
+  ReadFieldMap(field_map_file);
+  ComputeDriftTable(table_file);
+
+  if (!MapDriftTable(table_file)) {
+    G4String msg = "Cannot load the drift table " + table_file + " just computed.";
+    G4Exception("[RadiusDependentDriftField]", "LoadDriftTable()",
+                FatalException, msg);
+  }
 }
 
 
 
-G4double RadiusDependentDriftField::Drift(G4LorentzVector& /*xyzt*/)
+G4double RadiusDependentDriftField::Drift(G4LorentzVector& xyzt)
 {
-  return 0.;
+  // Without a drift table, or outside it, the charge carrier
+  // doesn't move (and will therefore be killed by the drift process).
+  if (!table_) return 0.;
+
+  G4double z = xyzt.z();
+  if (z > std::max(anode_pos_, cathode_pos_) ||
+      z < std::min(anode_pos_, cathode_pos_)) return 0.;
+
+  G4double r = xyzt.perp();
+  if (r < header_->rmin || r > header_->rmax ||
+      z < header_->zmin || z > header_->zmax) return 0.;
+
+  // Locate the grid cell and the position within it
+  G4double fr = (r - header_->rmin) / dr_;
+  G4double fz = (z - header_->zmin) / dz_;
+  G4int ir = std::min(static_cast<G4int>(fr), header_->nr - 2);
+  G4int iz = std::min(static_cast<G4int>(fz), header_->nz - 2);
+  fr -= ir;
+  fz -= iz;
+
+  const G4int nz = header_->nz;
+  const TableEntry& e00 = table_[ ir   *nz + iz  ];
+  const TableEntry& e01 = table_[ ir   *nz + iz+1];
+  const TableEntry& e10 = table_[(ir+1)*nz + iz  ];
+  const TableEntry& e11 = table_[(ir+1)*nz + iz+1];
+
+  // Electrons starting close to a drift line that does not
+  // reach the anode are considered lost
+  if (e00.end_r < 0. || e01.end_r < 0. || e10.end_r < 0. || e11.end_r < 0.)
+    return 0.;
+
+  const G4double w00 = (1.-fr)*(1.-fz);
+  const G4double w01 = (1.-fr)*fz;
+  const G4double w10 = fr*(1.-fz);
+  const G4double w11 = fr*fz;
+
+  G4double end_r = w00*e00.end_r + w01*e01.end_r + w10*e10.end_r + w11*e11.end_r;
+  G4double drift_time =
+    w00*e00.drift_time + w01*e01.drift_time + w10*e10.drift_time + w11*e11.drift_time;
+  G4double transv_sigma =
+    w00*e00.transv_sigma + w01*e01.transv_sigma + w10*e10.transv_sigma + w11*e11.transv_sigma;
+  G4double time_sigma =
+    w00*e00.time_sigma + w01*e01.time_sigma + w10*e10.time_sigma + w11*e11.time_sigma;
+
+  // Set the offset according to relative anode-cathode pos
+  G4double secmargin = -1. * micrometer;
+  if (anode_pos_ > cathode_pos_) secmargin = -secmargin;
+
+  // The field is symmetric in azimuth, so the electron keeps its phi
+  G4double phi = xyzt.phi();
+  G4ThreeVector position(G4RandGauss::shoot(end_r * cos(phi), transv_sigma),
+                         G4RandGauss::shoot(end_r * sin(phi), transv_sigma),
+                         anode_pos_ + secmargin);
+
+  G4double time = xyzt.t() + drift_time + G4RandGauss::shoot(0., time_sigma);
+  if (time < 0.) time = xyzt.t() + drift_time;
+
+  G4ThreeVector displacement = position - xyzt.vect();
+  G4double step_length = displacement.mag();
+
+  xyzt.set(time, position);
+
+  return step_length;
 }
 
 
 
 G4LorentzVector
-RadiusDependentDriftField::GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&)
+RadiusDependentDriftField::GeneratePointAlongDriftLine(const G4LorentzVector& origin,
+                                                       const G4LorentzVector& end)
+{
+  rnd_->SetPoints(origin, end);
+  return rnd_->Shoot();
+}
+
+
+
+uint64_t RadiusDependentDriftField::HashFieldMap(const G4String& filename) const
+{
+  std::ifstream file(filename, std::ifstream::binary);
+  if (!file.is_open()) return 0;
+
+  // 64-bit FNV-1a hash of the contents of the file
+  uint64_t hash = 14695981039346656037ULL;
+  char buffer[65536];
+  while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0) {
+    for (std::streamsize i=0; i<file.gcount(); ++i) {
+      hash ^= static_cast<unsigned char>(buffer[i]);
+      hash *= 1099511628211ULL;
+    }
+  }
+
+  return hash;
+}
+
+
+
+void RadiusDependentDriftField::ReadFieldMap(const G4String& filename)
+{
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    G4String msg = "Cannot open field map " + filename;
+    G4Exception("[RadiusDependentDriftField]", "ReadFieldMap()",
+                FatalException, msg);
+  }
+
+  std::vector<G4double> rs, zs, ers, ezs;
+  std::set<G4double> r_nodes, z_nodes;
+
+  std::string line;
+  while (getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream ss(line);
+    G4double r, z, er, ez;
+    if (!(ss >> r >> z >> er >> ez)) continue;
+    rs.push_back(r * mm);
+    zs.push_back(z * mm);
+    ers.push_back(er);
+    ezs.push_back(ez);
+    r_nodes.insert(r * mm);
+    z_nodes.insert(z * mm);
+  }
+
+  map_nr_ = r_nodes.size();
+  map_nz_ = z_nodes.size();
+
+  if (map_nr_ < 2 || map_nz_ < 2 || rs.size() != size_t(map_nr_ * map_nz_)) {
+    G4String msg = "Field map " + filename + " is not a regular (r,z) grid.";
+    G4Exception("[RadiusDependentDriftField]", "ReadFieldMap()",
+                FatalException, msg);
+  }
+
+  map_rmin_ = *r_nodes.begin();
+  map_rmax_ = *r_nodes.rbegin();
+  map_zmin_ = *z_nodes.begin();
+  map_zmax_ = *z_nodes.rbegin();
+
+  G4double map_dr = (map_rmax_ - map_rmin_) / (map_nr_ - 1);
+  G4double map_dz = (map_zmax_ - map_zmin_) / (map_nz_ - 1);
+
+  map_er_.assign(map_nr_ * map_nz_, 0.);
+  map_ez_.assign(map_nr_ * map_nz_, 0.);
+
+  for (size_t i=0; i<rs.size(); ++i) {
+    G4int ir = std::lround((rs[i] - map_rmin_) / map_dr);
+    G4int iz = std::lround((zs[i] - map_zmin_) / map_dz);
+    map_er_[ir * map_nz_ + iz] = ers[i];
+    map_ez_[ir * map_nz_ + iz] = ezs[i];
+  }
+}
+
+
+
+void RadiusDependentDriftField::FieldAt(G4double r, G4double z,
+                                        G4double& er, G4double& ez) const
+{
+  G4double fr = (r - map_rmin_) / (map_rmax_ - map_rmin_) * (map_nr_ - 1);
+  G4double fz = (z - map_zmin_) / (map_zmax_ - map_zmin_) * (map_nz_ - 1);
+  G4int ir = std::max(0, std::min(static_cast<G4int>(fr), map_nr_ - 2));
+  G4int iz = std::max(0, std::min(static_cast<G4int>(fz), map_nz_ - 2));
+  fr -= ir;
+  fz -= iz;
+
+  const G4int i00 =  ir   *map_nz_ + iz;
+  const G4int i01 =  ir   *map_nz_ + iz+1;
+  const G4int i10 = (ir+1)*map_nz_ + iz;
+  const G4int i11 = (ir+1)*map_nz_ + iz+1;
+
+  er = (1.-fr)*(1.-fz)*map_er_[i00] + (1.-fr)*fz*map_er_[i01] +
+    fr*(1.-fz)*map_er_[i10] + fr*fz*map_er_[i11];
+  ez = (1.-fr)*(1.-fz)*map_ez_[i00] + (1.-fr)*fz*map_ez_[i01] +
+    fr*(1.-fz)*map_ez_[i10] + fr*fz*map_ez_[i11];
+}
+
+
+
+RadiusDependentDriftField::TableEntry
+RadiusDependentDriftField::FollowDriftLine(G4double r, G4double z) const
+{
+  TableEntry entry;
+  entry.end_r = -1.;
+  entry.drift_time = 0.;
+  entry.drift_length = 0.;
+  entry.transv_sigma = 0.;
+  entry.time_sigma = 0.;
+
+  // Step along the drift line a fraction of the map granularity
+  const G4double step = 0.5 *
+    std::min((map_rmax_ - map_rmin_) / (map_nr_ - 1),
+             (map_zmax_ - map_zmin_) / (map_nz_ - 1));
+  const G4int max_steps = 100 * (map_nr_ + map_nz_);
+  const G4double toward = (anode_pos_ > cathode_pos_) ? 1. : -1.;
+
+  G4double length = 0.;
+
+  for (G4int n=0; (z - anode_pos_) * toward < 0.; ++n) {
+
+    if (n > max_steps) return entry;
+
+    G4double er, ez;
+    FieldAt(r, z, er, ez);
+    G4double mag = std::sqrt(er*er + ez*ez);
+    if (mag == 0.) return entry;
+
+    // Electrons drift against the field
+    G4double delta_r = -er / mag * step;
+    G4double delta_z = -ez / mag * step;
+
+    // Clip the last step at the anode
+    if ((z + delta_z - anode_pos_) * toward >= 0.) {
+      G4double frac = (anode_pos_ - z) / delta_z;
+      r += frac * delta_r;
+      length += frac * step;
+      z = anode_pos_;
+      break;
+    }
+
+    r += delta_r;
+    z += delta_z;
+    length += step;
+
+    // Crossing the axis of the detector
+    if (r < 0.) r = -r;
+
+    if (r > max_radius_ || r > map_rmax_ || z < map_zmin_ || z > map_zmax_)
+      return entry;
+  }
+
+  entry.end_r = std::abs(r);
+  entry.drift_length = length;
+  entry.drift_time = length / drift_velocity_;
+  entry.transv_sigma = transv_diff_ * std::sqrt(length);
+  entry.time_sigma = longit_diff_ * std::sqrt(length) / drift_velocity_;
+
+  return entry;
+}
+
+
+
+void RadiusDependentDriftField::ComputeDriftTable(const G4String& filename)
+{
+  TableHeader header;
+  std::memcpy(header.magic, table_magic, sizeof(header.magic));
+  header.nr = map_nr_;
+  header.nz = map_nz_;
+  header.rmin = map_rmin_;
+  header.rmax = map_rmax_;
+  header.zmin = map_zmin_;
+  header.zmax = map_zmax_;
+  header.anode_pos      = anode_pos_;
+  header.cathode_pos    = cathode_pos_;
+  header.max_radius     = max_radius_;
+  header.drift_velocity = drift_velocity_;
+  header.transv_diff    = transv_diff_;
+  header.longit_diff    = longit_diff_;
+  header.field_map_hash = map_hash_;
+
+  std::vector<TableEntry> entries(map_nr_ * map_nz_);
+
+  const G4double map_dr = (map_rmax_ - map_rmin_) / (map_nr_ - 1);
+  const G4double map_dz = (map_zmax_ - map_zmin_) / (map_nz_ - 1);
+
+  for (G4int ir=0; ir<map_nr_; ++ir)
+    for (G4int iz=0; iz<map_nz_; ++iz)
+      entries[ir * map_nz_ + iz] =
+        FollowDriftLine(map_rmin_ + ir * map_dr, map_zmin_ + iz * map_dz);
+
+  // The table is written to a temporary file and then renamed, so
+  // that other jobs never map a partially written (or replaced) table
+  G4String tmp_filename = filename + ".tmp" + std::to_string(getpid());
+  std::ofstream out(tmp_filename, std::ofstream::binary);
+  if (!out.is_open()) {
+    G4String msg = "Cannot write drift table " + filename;
+    G4Exception("[RadiusDependentDriftField]", "ComputeDriftTable()",
+                FatalException, msg);
+  }
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(entries.data()),
+            entries.size() * sizeof(TableEntry));
+  out.close();
+
+  if (rename(tmp_filename.c_str(), filename.c_str()) != 0) {
+    std::remove(tmp_filename.c_str());
+    G4String msg = "Cannot write drift table " + filename;
+    G4Exception("[RadiusDependentDriftField]", "ComputeDriftTable()",
+                FatalException, msg);
+  }
+
+  // The field map is no longer needed
+  map_er_.clear();
+  map_ez_.clear();
+}
+
+
+
+G4bool RadiusDependentDriftField::MapDriftTable(const G4String& filename)
+{
+  UnmapDriftTable();
+
+  int fd = open(filename.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) close(fd);
+    return false;
+  }
+
+  map_size_ = st.st_size;
+  map_addr_ = mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (map_addr_ == MAP_FAILED) {
+    map_addr_ = nullptr;
+    map_size_ = 0;
+    return false;
+  }
+
+  header_ = static_cast<const TableHeader*>(map_addr_);
+
+  if (map_size_ < sizeof(TableHeader) ||
+      std::memcmp(header_->magic, table_magic, sizeof(table_magic)) != 0 ||
+      header_->nr < 2 || header_->nz < 2 ||
+      map_size_ != sizeof(TableHeader) +
+                   size_t(header_->nr * header_->nz) * sizeof(TableEntry) ||
+      !SameParameter(header_->anode_pos,      anode_pos_)      ||
+      !SameParameter(header_->cathode_pos,    cathode_pos_)    ||
+      !SameParameter(header_->max_radius,     max_radius_)     ||
+      !SameParameter(header_->drift_velocity, drift_velocity_) ||
+      !SameParameter(header_->transv_diff,    transv_diff_)    ||
+      !SameParameter(header_->longit_diff,    longit_diff_)    ||
+      (map_hash_ && header_->field_map_hash != map_hash_)) {
+    UnmapDriftTable();
+    return false;
+  }
+
+  table_ = reinterpret_cast<const TableEntry*>
+    (static_cast<const char*>(map_addr_) + sizeof(TableHeader));
+
+  dr_ = (header_->rmax - header_->rmin) / (header_->nr - 1);
+  dz_ = (header_->zmax - header_->zmin) / (header_->nz - 1);
+
+  return true;
+}
+
+
+
+void RadiusDependentDriftField::UnmapDriftTable()
 {
-  return G4LorentzVector();
+  if (map_addr_) munmap(map_addr_, map_size_);
+  map_addr_ = nullptr;
+  map_size_ = 0;
+  header_ = nullptr;
+  table_ = nullptr;
 }
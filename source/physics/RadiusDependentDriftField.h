@@ -1,7 +1,11 @@
 // ----------------------------------------------------------------------------
 // nexus | RadiusDependentDriftField.h
 //
-// Drift field varying with radial coordinate.
+// Drift field varying with radial coordinate. The field is described by a
+// 2D (r,z) field map, from which a table with the end point of the drift
+// line starting at each node of a regular grid is precomputed once. The
+// table is stored in a binary file which is memory-mapped, so that drifting
+// an electron reduces to a bilinear interpolation in the table.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -13,14 +17,22 @@
 #include "BaseDriftField.h"
 #include <G4LorentzVector.hh>
 
+#include <vector>
+#include <cstdint>
+
 
 namespace nexus {
 
+  class SegmentPointSampler;
+
   class RadiusDependentDriftField: public BaseDriftField
   {
   public:
-    /// Constructor
-    RadiusDependentDriftField();
+    /// Constructor providing position of anode and cathode along the
+    /// z axis and the maximum radius reached by the drift region
+    RadiusDependentDriftField(G4double anode_position=0.,
+                              G4double cathode_position=0.,
+                              G4double max_radius=0.);
     /// Destructor
     ~RadiusDependentDriftField();
 
@@ -28,9 +40,149 @@ namespace nexus {
 
     virtual G4LorentzVector GeneratePointAlongDriftLine(const G4LorentzVector&, const G4LorentzVector&);
 
-    //virtual G4double LightYield() const;
+    /// Memory-maps the drift table stored in table_file. If the file
+    /// does not exist, the table is first computed from the field map
+    /// (text file with columns r, z, Er, Ez in a regular grid) and written.
+    /// The table depends on the field map (identified by a hash of its
+    /// contents), the anode and cathode positions, the maximum radius, the
+    /// drift velocity and the diffusion constants, which are stored in it:
+    /// if they don't match the current ones, the table is computed again,
+    /// or it is a fatal error if no field map is given. Without a field
+    /// map, only the parameters other than the field map are checked.
+    void LoadDriftTable(const G4String& table_file,
+                        const G4String& field_map_file="");
+
+    // Setters/getters
+
+    void SetAnodePosition(G4double);
+    G4double GetAnodePosition() const;
+
+    void SetCathodePosition(G4double);
+    G4double GetCathodePosition() const;
+
+    void SetMaxRadius(G4double);
+    G4double GetMaxRadius() const;
+
+    void SetDriftVelocity(G4double);
+    G4double GetDriftVelocity() const;
+
+    void SetLongitudinalDiffusion(G4double);
+    G4double GetLongitudinalDiffusion() const;
+
+    void SetTransverseDiffusion(G4double);
+    G4double GetTransverseDiffusion() const;
+
+    void SetLightYield(G4double);
+    virtual G4double LightYield() const;
+
+  private:
+    /// Header of the binary drift table file
+    struct TableHeader {
+      char     magic[8];
+      int32_t  nr, nz;
+      double   rmin, rmax, zmin, zmax;
+      // Parameters the table was computed with
+      double   anode_pos, cathode_pos, max_radius;
+      double   drift_velocity, transv_diff, longit_diff;
+      uint64_t field_map_hash;
+    };
+
+    /// Drift-line end point for a node of the grid. A negative end
+    /// radius means that the electron is lost before reaching the anode.
+    struct TableEntry {
+      float end_r;        ///< Radius at the anode (mm)
+      float drift_time;   ///< Drift time (ns)
+      float drift_length; ///< Length of the drift line (mm)
+      float transv_sigma; ///< Transverse diffusion at the anode (mm)
+      float time_sigma;   ///< Longitudinal diffusion expressed in time (ns)
+    };
+
+    void ReadFieldMap(const G4String&);
+    /// Returns a hash of the contents of the field map file
+    uint64_t HashFieldMap(const G4String&) const;
+    void ComputeDriftTable(const G4String&);
+    /// Maps the table, returning false (and leaving it unmapped) if
+    /// the file is not a valid table or its parameters don't match
+    G4bool MapDriftTable(const G4String&);
+    void UnmapDriftTable();
+
+    /// Returns the field at (r,z) interpolating the field map
+    void FieldAt(G4double r, G4double z, G4double& er, G4double& ez) const;
+
+    /// Follows the drift line starting at (r,z) until the anode
+    TableEntry FollowDriftLine(G4double r, G4double z) const;
+
+  private:
+    G4double anode_pos_;   ///< Anode position in z
+    G4double cathode_pos_; ///< Cathode position in z
+    G4double max_radius_;  ///< Radius beyond which electrons are lost
+
+    G4double drift_velocity_; ///< Drift velocity of the charge carrier
+    G4double transv_diff_;    ///< Transverse diffusion
+    G4double longit_diff_;    ///< Longitudinal diffusion
+    G4double light_yield_;
+
+    // Field map, only kept in memory while computing the drift table
+    G4int map_nr_, map_nz_;
+    G4double map_rmin_, map_rmax_, map_zmin_, map_zmax_;
+    std::vector<G4double> map_er_, map_ez_;
+    uint64_t map_hash_; ///< Hash of the field map (0 if not known)
+
+    // Memory-mapped drift table
+    void*  map_addr_;
+    size_t map_size_;
+    const TableHeader* header_;
+    const TableEntry*  table_;
+    G4double dr_, dz_;
+
+    SegmentPointSampler* rnd_;
   };
 
+
+  // inline methods ..................................................
+
+  inline void RadiusDependentDriftField::SetAnodePosition(G4double p)
+  { anode_pos_ = p; }
+
+  inline G4double RadiusDependentDriftField::GetAnodePosition() const
+  { return anode_pos_; }
+
+  inline void RadiusDependentDriftField::SetCathodePosition(G4double p)
+  { cathode_pos_ = p; }
+
+  inline G4double RadiusDependentDriftField::GetCathodePosition() const
+  { return cathode_pos_; }
+
+  inline void RadiusDependentDriftField::SetMaxRadius(G4double r)
+  { max_radius_ = r; }
+
+  inline G4double RadiusDependentDriftField::GetMaxRadius() const
+  { return max_radius_; }
+
+  inline void RadiusDependentDriftField::SetDriftVelocity(G4double dv)
+  { drift_velocity_ = dv; }
+
+  inline G4double RadiusDependentDriftField::GetDriftVelocity() const
+  { return drift_velocity_; }
+
+  inline void RadiusDependentDriftField::SetLongitudinalDiffusion(G4double ld)
+  { longit_diff_ = ld; }
+
+  inline G4double RadiusDependentDriftField::GetLongitudinalDiffusion() const
+  { return longit_diff_; }
+
+  inline void RadiusDependentDriftField::SetTransverseDiffusion(G4double td)
+  { transv_diff_ = td; }
+
+  inline G4double RadiusDependentDriftField::GetTransverseDiffusion() const
+  { return transv_diff_; }
+
+  inline void RadiusDependentDriftField::SetLightYield(G4double ly)
+  { light_yield_ = ly; }
+
+  inline G4double RadiusDependentDriftField::LightYield() const
+  { return light_yield_; }
+
 } // end namespace nexus
 
 #endif
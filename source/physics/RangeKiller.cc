@@ -0,0 +1,195 @@
+// ----------------------------------------------------------------------------
+// nexus | RangeKiller.cc
+//
+// Termination of particles in passive volumes. Charged particles whose
+// range in the current material is shorter than the distance to the
+// nearest target (active or sensitive) volume are stopped, as they cannot
+// deposit energy where it is recorded. Optionally, all particles below an
+// energy threshold are stopped as well.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "RangeKiller.h"
+
+#include "IonizationElectron.h"
+
+#include <G4ParticleDefinition.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4ProcessManager.hh>
+#include <G4LossTableManager.hh>
+#include <G4LogicalVolumeStore.hh>
+#include <G4TransportationManager.hh>
+#include <G4Navigator.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4LogicalVolume.hh>
+#include <G4UserLimits.hh>
+#include <G4VSolid.hh>
+
+#include <algorithm>
+
+
+namespace nexus {
+
+
+  RangeKiller::RangeKiller(const std::vector<G4String>& volumes,
+                           const std::vector<G4String>& targets,
+                           G4double kill_energy,
+                           const G4String& process_name,
+                           G4ProcessType type):
+    G4VDiscreteProcess(process_name, type), ParticleChange_(0),
+    kill_energy_(kill_energy)
+  {
+    ParticleChange_ = new G4ParticleChange();
+    pParticleChange = ParticleChange_;
+
+    // The geometry is already constructed when
+    // the physics processes are created
+    G4LogicalVolumeStore* lvstore = G4LogicalVolumeStore::GetInstance();
+
+    for (auto& name: volumes) {
+      G4LogicalVolume* lv = lvstore->GetVolume(name, false);
+      if (!lv)
+        G4Exception("[RangeKiller]", "RangeKiller()", FatalException,
+                    ("Unknown logical volume " + name).c_str());
+      volumes_.insert(lv);
+    }
+
+    for (auto& name: targets) {
+      G4LogicalVolume* lv = lvstore->GetVolume(name, false);
+      if (!lv)
+        G4Exception("[RangeKiller]", "RangeKiller()", FatalException,
+                    ("Unknown logical volume " + name).c_str());
+      target_volumes_.insert(lv);
+    }
+
+    if (!target_volumes_.empty()) {
+      G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()->
+        GetNavigatorForTracking()->GetWorldVolume();
+      FindTargets(world, G4AffineTransform());
+      if (targets_.empty())
+        G4Exception("[RangeKiller]", "RangeKiller()", FatalException,
+                    "None of the target volumes is placed in the geometry.");
+    }
+  }
+
+
+
+  RangeKiller::~RangeKiller()
+  {
+    delete ParticleChange_;
+  }
+
+
+
+  G4bool RangeKiller::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    if (pdef == *G4OpticalPhoton::Definition() ||
+        pdef == *IonizationElectron::Definition() ||
+        pdef.IsShortLived()) return false;
+
+    return true;
+  }
+
+
+
+  G4VParticleChange*
+  RangeKiller::PostStepDoIt(const G4Track& track, const G4Step& step)
+  {
+    ParticleChange_->Initialize(track);
+
+    const G4StepPoint* post = step.GetPostStepPoint();
+    const G4VPhysicalVolume* pv = post->GetPhysicalVolume();
+    if (!pv) return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    const G4LogicalVolume* lv = pv->GetLogicalVolume();
+    if (volumes_.find(lv) == volumes_.end())
+      return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    G4double energy = track.GetKineticEnergy();
+    if (energy <= 0.) return G4VDiscreteProcess::PostStepDoIt(track, step);
+
+    // Energy threshold: the minimum kinetic energy of the
+    // user limits of the volume, if any, overrides the global one
+    G4double threshold = kill_energy_;
+    G4UserLimits* limits = lv->GetUserLimits();
+    if (limits) threshold = std::max(threshold, limits->GetUserMinEkine(track));
+
+    G4bool kill = energy < threshold;
+
+    // Range rejection, only for charged particles. The range is the
+    // restricted one computed by the energy-loss tables, which is larger
+    // than the CSDA range, so the test is conservative.
+    if (!kill && !targets_.empty() && track.GetDefinition()->GetPDGCharge() != 0.) {
+      G4double range = G4LossTableManager::Instance()->
+        GetRange(track.GetDefinition(), energy, track.GetMaterialCutsCouple());
+      // The safety is the distance to the nearest boundary, that must
+      // be crossed in any case to reach a target
+      G4double distance = std::max(post->GetSafety(),
+                                   DistanceToTargets(post->GetPosition()));
+      kill = range < distance;
+    }
+
+    if (kill) {
+      ParticleChange_->ProposeLocalEnergyDeposit(energy);
+      ParticleChange_->ProposeEnergy(0.);
+      // Particles with at-rest processes (e.g. positron annihilation)
+      // are kept alive so that those are still invoked
+      G4ProcessManager* pmanager = track.GetDefinition()->GetProcessManager();
+      if (pmanager && pmanager->GetAtRestProcessVector()->size() > 0)
+        ParticleChange_->ProposeTrackStatus(fStopButAlive);
+      else
+        ParticleChange_->ProposeTrackStatus(fStopAndKill);
+    }
+
+    return ParticleChange_;
+  }
+
+
+
+  void RangeKiller::FindTargets(const G4VPhysicalVolume* pv,
+                                const G4AffineTransform& to_local)
+  {
+    const G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+    if (target_volumes_.find(lv) != target_volumes_.end()) {
+      Target t = {lv->GetSolid(), to_local};
+      targets_.push_back(t);
+      return;
+    }
+
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i) {
+      const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+      // Replicated and parameterised volumes are not followed;
+      // targets are expected to be simple placements
+      if (daughter->IsReplicated()) continue;
+
+      G4AffineTransform daughter_to_local;
+      daughter_to_local.InverseProduct(to_local,
+        G4AffineTransform(daughter->GetRotation(), daughter->GetTranslation()));
+      FindTargets(daughter, daughter_to_local);
+    }
+  }
+
+
+
+  G4double RangeKiller::DistanceToTargets(const G4ThreeVector& position) const
+  {
+    G4double distance = DBL_MAX;
+    for (auto& t: targets_) {
+      G4ThreeVector local = t.to_local.TransformPoint(position);
+      distance = std::min(distance, t.solid->DistanceToIn(local));
+    }
+    return distance;
+  }
+
+
+
+  G4double RangeKiller::GetMeanFreePath(const G4Track&,
+    G4double, G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+} // end namespace nexus
@@ -0,0 +1,84 @@
+// ----------------------------------------------------------------------------
+// nexus | RangeKiller.h
+//
+// Termination of particles in passive volumes. Charged particles whose
+// range in the current material is shorter than the distance to the
+// nearest target (active or sensitive) volume are stopped, as they cannot
+// deposit energy where it is recorded. Optionally, all particles below an
+// energy threshold are stopped as well.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef RANGE_KILLER_H
+#define RANGE_KILLER_H
+
+#include <G4VDiscreteProcess.hh>
+#include <G4AffineTransform.hh>
+
+#include <vector>
+#include <set>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+
+namespace nexus {
+
+  class RangeKiller: public G4VDiscreteProcess
+  {
+  public:
+    /// Constructor taking the names of the logical volumes where particles
+    /// are killed, the names of the target logical volumes and the energy
+    /// threshold below which any particle is killed (0 to disable it)
+    RangeKiller(const std::vector<G4String>& volumes,
+                const std::vector<G4String>& targets,
+                G4double kill_energy=0.,
+                const G4String& process_name="RangeKiller",
+                G4ProcessType type = fUserDefined);
+    /// Destructor
+    ~RangeKiller();
+
+    /// Returns true for any particle but ionization
+    /// electrons, optical photons and short-lived particles
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Stops the track if it lies in one of the passive volumes and
+    /// either its energy is below the threshold or its range is shorter
+    /// than the distance to the targets
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+  private:
+    /// Returns infinity; i. e. the process does not limit the step,
+    /// but sets the 'StronglyForced' condition for the PostStepDoIt
+    /// to be invoked at every step
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+    /// Stores the placements of the target volumes found
+    /// in the geometry tree below the given physical volume
+    void FindTargets(const G4VPhysicalVolume*, const G4AffineTransform&);
+
+    /// Returns a lower bound of the distance from the
+    /// given point (global coordinates) to the targets
+    G4double DistanceToTargets(const G4ThreeVector&) const;
+
+  private:
+    /// Placement of a target volume
+    struct Target {
+      const G4VSolid* solid;
+      G4AffineTransform to_local; ///< Global to local transformation
+    };
+
+    G4ParticleChange* ParticleChange_;
+
+    std::set<const G4LogicalVolume*> volumes_; ///< Passive volumes
+    std::set<const G4LogicalVolume*> target_volumes_;
+    std::vector<Target> targets_;
+
+    G4double kill_energy_;
+  };
+
+} // end namespace nexus
+
+#endif
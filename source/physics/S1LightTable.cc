@@ -0,0 +1,178 @@
+// ----------------------------------------------------------------------------
+// nexus | S1LightTable.cc
+//
+// Look-up table of the primary scintillation (S1) response of the
+// photosensors. For each voxel of a regular (x,y,z) grid, it stores the
+// probability that a photon emitted in the voxel is detected by each
+// sensor and a template of the photon arrival time distribution.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "S1LightTable.h"
+
+#include <Randomize.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+
+using namespace nexus;
+
+
+S1LightTable::S1LightTable(const G4String& filename):
+  sensdet_(""), nx_(0), ny_(0), nz_(0),
+  xmin_(0.), ymin_(0.), zmin_(0.), dx_(0.), dy_(0.), dz_(0.)
+{
+  ReadFile(filename);
+}
+
+
+
+S1LightTable::~S1LightTable()
+{
+}
+
+
+
+void S1LightTable::ReadFile(const G4String& filename)
+{
+  std::ifstream file(filename);
+  if (!file.is_open()) {
+    G4Exception("[S1LightTable]", "ReadFile()", FatalException,
+                ("Cannot open S1 light table " + filename).c_str());
+  }
+
+  std::vector<std::vector<Entry> > voxels;
+  std::vector<G4int> voxel_template_id;
+  std::map<G4int, G4int> template_index;
+
+  G4String line;
+  G4int line_number = 0;
+
+  while (std::getline(file, line)) {
+    ++line_number;
+    if (line.empty() || line[0] == '#') continue;
+
+    std::istringstream ss(line);
+    G4String key;
+    ss >> key;
+    G4bool ok = true;
+
+    if (key == "sensdet") {
+      ok = bool(ss >> sensdet_);
+    }
+    else if (key == "grid") {
+      G4double xmax, ymax, zmax;
+      ok = bool(ss >> nx_ >> ny_ >> nz_ >> xmin_ >> xmax >> ymin_ >> ymax >> zmin_ >> zmax) &&
+        nx_ > 0 && ny_ > 0 && nz_ > 0 && xmax > xmin_ && ymax > ymin_ && zmax > zmin_;
+      if (ok) {
+        dx_ = (xmax - xmin_) / nx_;
+        dy_ = (ymax - ymin_) / ny_;
+        dz_ = (zmax - zmin_) / nz_;
+        voxels.assign(nx_ * ny_ * nz_, std::vector<Entry>());
+        voxel_template_id.assign(nx_ * ny_ * nz_, -1);
+      }
+    }
+    else if (key == "template") {
+      G4int id, nbins;
+      G4double bin_width;
+      ok = bool(ss >> id >> bin_width >> nbins) && bin_width > 0. && nbins > 0;
+      TimeTemplate tmpl;
+      tmpl.bin_width = bin_width * ns;
+      G4double sum = 0.;
+      for (G4int i=0; ok && i<nbins; ++i) {
+        G4double w;
+        ok = bool(ss >> w) && w >= 0.;
+        sum += w;
+        tmpl.cdf.push_back(sum);
+      }
+      ok = ok && sum > 0.;
+      if (ok) {
+        for (G4double& c: tmpl.cdf) c /= sum;
+        template_index[id] = templates_.size();
+        templates_.push_back(tmpl);
+      }
+    }
+    else if (key == "voxel") {
+      G4int ix, iy, iz, id;
+      ok = !voxels.empty() && bool(ss >> ix >> iy >> iz >> id) &&
+        ix >= 0 && ix < nx_ && iy >= 0 && iy < ny_ && iz >= 0 && iz < nz_;
+      if (ok) {
+        G4int index = (ix * ny_ + iy) * nz_ + iz;
+        voxel_template_id[index] = id;
+        Entry entry;
+        while (ss >> entry.sensor_id >> entry.prob)
+          if (entry.prob > 0.) voxels[index].push_back(entry);
+      }
+    }
+    else {
+      ok = false;
+    }
+
+    if (!ok) {
+      std::ostringstream msg;
+      msg << "Wrong format in line " << line_number << " of " << filename;
+      G4Exception("[S1LightTable]", "ReadFile()", FatalException, msg.str().c_str());
+    }
+  }
+
+  if (sensdet_ == "" || voxels.empty()) {
+    G4Exception("[S1LightTable]", "ReadFile()", FatalException,
+                ("Missing sensdet or grid line in " + filename).c_str());
+  }
+
+  // Store the sensors of all voxels contiguously
+  offsets_.assign(1, 0);
+  voxel_template_.assign(voxels.size(), -1);
+
+  for (size_t i=0; i<voxels.size(); ++i) {
+    entries_.insert(entries_.end(), voxels[i].begin(), voxels[i].end());
+    offsets_.push_back(entries_.size());
+
+    if (voxels[i].empty()) continue;
+
+    auto it = template_index.find(voxel_template_id[i]);
+    if (it == template_index.end()) {
+      std::ostringstream msg;
+      msg << "Unknown time template " << voxel_template_id[i] << " in " << filename;
+      G4Exception("[S1LightTable]", "ReadFile()", FatalException, msg.str().c_str());
+    }
+    voxel_template_[i] = it->second;
+  }
+}
+
+
+
+G4bool S1LightTable::Find(const G4ThreeVector& point, const Entry*& begin,
+                          const Entry*& end, G4int& time_template) const
+{
+  G4int ix = std::floor((point.x() - xmin_) / dx_);
+  G4int iy = std::floor((point.y() - ymin_) / dy_);
+  G4int iz = std::floor((point.z() - zmin_) / dz_);
+
+  if (ix < 0 || ix >= nx_ || iy < 0 || iy >= ny_ || iz < 0 || iz >= nz_)
+    return false;
+
+  G4int index = (ix * ny_ + iy) * nz_ + iz;
+  if (offsets_[index] == offsets_[index+1]) return false;
+
+  begin = entries_.data() + offsets_[index];
+  end   = entries_.data() + offsets_[index+1];
+  time_template = voxel_template_[index];
+
+  return true;
+}
+
+
+
+G4double S1LightTable::SampleDelay(G4int time_template) const
+{
+  const TimeTemplate& tmpl = templates_[time_template];
+  size_t bin = std::lower_bound(tmpl.cdf.begin(), tmpl.cdf.end(), G4UniformRand())
+    - tmpl.cdf.begin();
+  bin = std::min(bin, tmpl.cdf.size() - 1);
+  return (bin + G4UniformRand()) * tmpl.bin_width;
+}
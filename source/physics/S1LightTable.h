@@ -0,0 +1,88 @@
+// ----------------------------------------------------------------------------
+// nexus | S1LightTable.h
+//
+// Look-up table of the primary scintillation (S1) response of the
+// photosensors. For each voxel of a regular (x,y,z) grid, it stores the
+// probability that a photon emitted in the voxel is detected by each
+// sensor and a template of the photon arrival time distribution.
+//
+// The table is read from a text file with the following lines
+// (lengths in mm, times in ns; lines starting with '#' are ignored):
+//
+//   sensdet  <name of the PmtSD of the sensors>
+//   grid     <nx> <ny> <nz> <xmin> <xmax> <ymin> <ymax> <zmin> <zmax>
+//   template <id> <bin width> <nbins> <w_0> ... <w_nbins-1>
+//   voxel    <ix> <iy> <iz> <template id> <sensor id> <prob> [<sensor id> <prob> ...]
+//
+// Voxels not listed in the file produce no light.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef S1_LIGHT_TABLE_H
+#define S1_LIGHT_TABLE_H
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class S1LightTable
+  {
+  public:
+    /// Detection probability of a sensor
+    struct Entry {
+      G4int sensor_id;
+      G4float prob;
+    };
+
+    /// Constructor reading the table from a file
+    S1LightTable(const G4String& filename);
+    /// Destructor
+    ~S1LightTable();
+
+    /// Returns the sensors that see the voxel containing the given point,
+    /// as the range [begin, end), and the index of its time template.
+    /// Returns false if the point is outside the grid or the voxel is empty.
+    G4bool Find(const G4ThreeVector& point, const Entry*& begin,
+                const Entry*& end, G4int& time_template) const;
+
+    /// Samples the delay between emission and detection of a photon
+    G4double SampleDelay(G4int time_template) const;
+
+    /// Name of the sensitive detector of the sensors of the table
+    const G4String& GetSensitiveDetectorName() const;
+
+  private:
+    void ReadFile(const G4String&);
+
+  private:
+    /// Time template, stored as a normalised cumulative distribution
+    struct TimeTemplate {
+      G4double bin_width;
+      std::vector<G4double> cdf;
+    };
+
+    G4String sensdet_;
+
+    G4int nx_, ny_, nz_;
+    G4double xmin_, ymin_, zmin_;
+    G4double dx_, dy_, dz_;
+
+    /// Sensors of voxel i are entries_[offsets_[i]] to entries_[offsets_[i+1]]
+    std::vector<unsigned int> offsets_;
+    std::vector<Entry> entries_;
+    std::vector<G4int> voxel_template_;
+
+    std::vector<TimeTemplate> templates_;
+  };
+
+  inline const G4String& S1LightTable::GetSensitiveDetectorName() const
+  { return sensdet_; }
+
+} // end namespace nexus
+
+#endif
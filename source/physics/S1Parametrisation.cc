@@ -0,0 +1,177 @@
+// ----------------------------------------------------------------------------
+// nexus | S1Parametrisation.cc
+//
+// Fast simulation of the primary scintillation (S1). The scintillation
+// photons produced in each step are not generated; instead, the number of
+// photons detected by each photosensor is sampled from an S1 light table
+// and recorded directly in the hits of its sensitive detector.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "S1Parametrisation.h"
+
+#include "S1LightTable.h"
+#include "PhotonThinning.h"
+#include "IonizationElectron.h"
+#include "PmtSD.h"
+
+#include <G4ParticleDefinition.hh>
+#include <G4OpticalPhoton.hh>
+#include <G4Gamma.hh>
+#include <G4ProcessTable.hh>
+#include <G4SDManager.hh>
+#include <G4Poisson.hh>
+#include <G4Material.hh>
+#include <Randomize.hh>
+
+#include <cmath>
+
+
+namespace nexus {
+
+
+  S1Parametrisation::S1Parametrisation(const std::vector<G4String>& table_files,
+                                       const G4String& process_name,
+                                       G4ProcessType type):
+    G4VRestDiscreteProcess(process_name, type), ParticleChange_(0)
+  {
+    ParticleChange_ = new G4ParticleChange();
+    pParticleChange = ParticleChange_;
+
+    for (const G4String& file: table_files)
+      tables_.push_back(new S1LightTable(file));
+
+    // Sensitive detectors are looked up at the first step,
+    // once the geometry has been constructed
+    sensdets_.assign(tables_.size(), 0);
+  }
+
+
+
+  S1Parametrisation::~S1Parametrisation()
+  {
+    for (S1LightTable* table: tables_) delete table;
+    delete ParticleChange_;
+  }
+
+
+
+  G4bool S1Parametrisation::IsApplicable(const G4ParticleDefinition& pdef)
+  {
+    if (pdef == *G4OpticalPhoton::Definition() ||
+        pdef == *IonizationElectron::Definition()) return false;
+
+    else if ((pdef.GetPDGCharge() != 0.) ||
+             (pdef == *G4Gamma::Definition())) return true;
+
+    else return false;
+  }
+
+
+
+  void S1Parametrisation::BuildPhysicsTable(const G4ParticleDefinition& pdef)
+  {
+    G4ProcessTable* process_table = G4ProcessTable::GetProcessTable();
+    if (process_table->FindProcess("Scintillation", &pdef))
+      process_table->SetProcessActivation("Scintillation", &pdef, false);
+  }
+
+
+
+  G4VParticleChange*
+  S1Parametrisation::AtRestDoIt(const G4Track& track, const G4Step& step)
+  {
+    return S1Parametrisation::PostStepDoIt(track, step);
+  }
+
+
+
+  G4VParticleChange*
+  S1Parametrisation::PostStepDoIt(const G4Track& track, const G4Step& step)
+  {
+    ParticleChange_->Initialize(track);
+
+    G4double energy_dep = step.GetTotalEnergyDeposit();
+    if (energy_dep <= 0.)
+      return G4VRestDiscreteProcess::PostStepDoIt(track, step);
+
+    // Only scintillating materials produce S1 light
+    const G4MaterialPropertiesTable* mpt =
+      track.GetMaterial()->GetMaterialPropertiesTable();
+    if (!mpt || !mpt->ConstPropertyExists("SCINTILLATIONYIELD"))
+      return G4VRestDiscreteProcess::PostStepDoIt(track, step);
+
+    // The yield of the material is reduced by photon thinning,
+    // while the detection probabilities of the table are not
+    G4double mean_photons = energy_dep *
+      mpt->GetConstProperty("SCINTILLATIONYIELD") / PhotonThinning::GetSurvivalFactor();
+
+    const G4StepPoint* pre  = step.GetPreStepPoint();
+    const G4StepPoint* post = step.GetPostStepPoint();
+    G4ThreeVector position = .5 * (pre->GetPosition() + post->GetPosition());
+
+    for (size_t t=0; t<tables_.size(); ++t) {
+
+      const S1LightTable::Entry* begin;
+      const S1LightTable::Entry* end;
+      G4int time_template;
+      if (!tables_[t]->Find(position, begin, end, time_template)) continue;
+
+      if (!sensdets_[t]) {
+        const G4String& name = tables_[t]->GetSensitiveDetectorName();
+        sensdets_[t] = dynamic_cast<PmtSD*>
+          (G4SDManager::GetSDMpointer()->FindSensitiveDetector(name, false));
+        if (!sensdets_[t])
+          G4Exception("[S1Parametrisation]", "PostStepDoIt()", FatalException,
+                      ("Unknown PmtSD " + name + " in S1 light table").c_str());
+      }
+
+      for (const S1LightTable::Entry* entry=begin; entry!=end; ++entry) {
+        G4int counts = G4Poisson(mean_photons * entry->prob);
+        for (G4int i=0; i<counts; ++i) {
+          G4double time = pre->GetGlobalTime() +
+            G4UniformRand() * (post->GetGlobalTime() - pre->GetGlobalTime()) +
+            SampleDecayTime(mpt) + tables_[t]->SampleDelay(time_template);
+          sensdets_[t]->AddDetectedPhotons(entry->sensor_id, time);
+        }
+      }
+    }
+
+    return G4VRestDiscreteProcess::PostStepDoIt(track, step);
+  }
+
+
+
+  G4double S1Parametrisation::SampleDecayTime(const G4MaterialPropertiesTable* mpt) const
+  {
+    if (!mpt->ConstPropertyExists("FASTTIMECONSTANT")) return 0.;
+
+    G4double tau = mpt->GetConstProperty("FASTTIMECONSTANT");
+    if (mpt->ConstPropertyExists("SLOWTIMECONSTANT") &&
+        mpt->ConstPropertyExists("YIELDRATIO") &&
+        G4UniformRand() > mpt->GetConstProperty("YIELDRATIO"))
+      tau = mpt->GetConstProperty("SLOWTIMECONSTANT");
+
+    return -tau * std::log(G4UniformRand());
+  }
+
+
+
+  G4double S1Parametrisation::GetMeanFreePath(const G4Track&,
+    G4double, G4ForceCondition* condition)
+  {
+    *condition = StronglyForced;
+    return DBL_MAX;
+  }
+
+
+
+  G4double S1Parametrisation::GetMeanLifeTime(const G4Track&,
+    G4ForceCondition* condition)
+  {
+    *condition = Forced;
+    return DBL_MAX;
+  }
+
+} // end namespace nexus
@@ -0,0 +1,72 @@
+// ----------------------------------------------------------------------------
+// nexus | S1Parametrisation.h
+//
+// Fast simulation of the primary scintillation (S1). The scintillation
+// photons produced in each step are not generated; instead, the number of
+// photons detected by each photosensor is sampled from an S1 light table
+// and recorded directly in the hits of its sensitive detector.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef S1_PARAMETRISATION_H
+#define S1_PARAMETRISATION_H
+
+#include <G4VRestDiscreteProcess.hh>
+
+#include <vector>
+
+
+namespace nexus {
+
+  class S1LightTable;
+  class PmtSD;
+
+  class S1Parametrisation: public G4VRestDiscreteProcess
+  {
+  public:
+    /// Constructor taking the files of the S1 light tables
+    /// (one per sensitive detector; see S1LightTable for the format)
+    S1Parametrisation(const std::vector<G4String>& table_files,
+                      const G4String& process_name="S1Parametrisation",
+                      G4ProcessType type = fUserDefined);
+    /// Destructor
+    ~S1Parametrisation();
+
+    /// Returns true for any particle but ionization
+    /// electrons and optical photons (see IonizationClustering)
+    G4bool IsApplicable(const G4ParticleDefinition&);
+
+    /// Deactivates the standard scintillation process
+    /// for the particle, whose light is now parametrised
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+
+    /// Records the S1 light detected for the energy deposited in the step
+    G4VParticleChange* PostStepDoIt(const G4Track&, const G4Step&);
+
+    /// Records the S1 light detected for the energy
+    /// given to the medium by particles at rest
+    G4VParticleChange* AtRestDoIt(const G4Track&, const G4Step&);
+
+  private:
+    /// Returns infinity, setting the 'StronglyForced' condition
+    /// for the PostStepDoIt to be invoked at every step
+    G4double GetMeanFreePath(const G4Track&, G4double, G4ForceCondition*);
+
+    /// Returns infinity, setting the 'Forced' condition
+    /// for the AtRestDoIt to be invoked
+    G4double GetMeanLifeTime(const G4Track&, G4ForceCondition*);
+
+    /// Samples the scintillation decay time of the material
+    G4double SampleDecayTime(const G4MaterialPropertiesTable*) const;
+
+  private:
+    G4ParticleChange* ParticleChange_;
+
+    std::vector<S1LightTable*> tables_;
+    std::vector<PmtSD*> sensdets_; ///< Sensitive detector of each table
+  };
+
+} // end namespace nexus
+
+#endif
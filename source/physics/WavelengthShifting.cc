@@ -54,16 +54,15 @@ namespace nexus {
     ParticleChange_->ProposeTrackStatus(fStopAndKill);
 
     const G4Material* material = track.GetMaterial();
+    G4int materialIndex = material->GetIndex();
 
     G4StepPoint* pPostStepPoint = step.GetPostStepPoint();
 
-   G4MaterialPropertiesTable* aMaterialPropertiesTable =
-     material->GetMaterialPropertiesTable();
-   if (!aMaterialPropertiesTable)
+   if (materialIndex >= (G4int)conv_efficiency_.size())
      return G4VDiscreteProcess::PostStepDoIt(track, step);
 
-   G4MaterialPropertyVector* WLS_Conversion_Efficiency=
-     aMaterialPropertiesTable->GetProperty("WLSCONVEFFICIENCY");
+   G4MaterialPropertyVector* WLS_Conversion_Efficiency =
+     conv_efficiency_[materialIndex];
 
    if (!WLS_Conversion_Efficiency) {
      return G4VDiscreteProcess::PostStepDoIt(track, step);
@@ -81,7 +80,6 @@ namespace nexus {
    }
    ParticleChange_->SetNumberOfSecondaries(1);
 
-   G4int materialIndex = material->GetIndex();
    G4PhysicsOrderedFreeVector* WLSIntegral  =
      (G4PhysicsOrderedFreeVector*)((*wlsIntegralTable_)(materialIndex));
 
@@ -131,7 +129,7 @@ namespace nexus {
    aWLSPhoton->SetKineticEnergy(sampledEnergy);
 
     // Generate new G4Track object and give position of WLS optical photon
-   G4double WLSTime = aMaterialPropertiesTable->GetConstProperty("WLSTIMECONSTANT");
+   G4double WLSTime = wls_time_[materialIndex];
    G4double TimeDelay = WLSTimeGeneratorProfile_->GenerateTime(WLSTime);
    G4double aSecondaryTime = (pPostStepPoint->GetGlobalTime()) + TimeDelay;
    G4ThreeVector aSecondaryPosition = pPostStepPoint->GetPosition();
@@ -185,32 +183,51 @@ namespace nexus {
     }
   }
 
+  void WavelengthShifting::BuildPhysicsTable(const G4ParticleDefinition&)
+  {
+    const G4MaterialTable* theMaterialTable =
+      G4Material::GetMaterialTable();
+    G4int numOfMaterials = G4Material::GetNumberOfMaterials();
+
+    conv_efficiency_.assign(numOfMaterials, nullptr);
+    wls_time_.assign(numOfMaterials, 0.);
+
+    for (G4int i=0 ; i < numOfMaterials; i++) {
+      G4MaterialPropertiesTable* aMaterialPropertiesTable =
+	(*theMaterialTable)[i]->GetMaterialPropertiesTable();
+      if (!aMaterialPropertiesTable) continue;
+
+      conv_efficiency_[i] =
+	aMaterialPropertiesTable->GetProperty("WLSCONVEFFICIENCY");
+      if (conv_efficiency_[i] &&
+	  aMaterialPropertiesTable->ConstPropertyExists("WLSTIMECONSTANT"))
+	wls_time_[i] = aMaterialPropertiesTable->GetConstProperty("WLSTIMECONSTANT");
+    }
+  }
+
   G4double WavelengthShifting::GetMeanFreePath(const G4Track& track, G4double, G4ForceCondition* /*condition*/)
   {
     G4double AttenuationLength = DBL_MAX;
 
-     const G4Material* material = track.GetMaterial();
-     G4MaterialPropertiesTable* aMaterialPropertiesTable = material->GetMaterialPropertiesTable();
-     if (aMaterialPropertiesTable) {
-       G4MaterialPropertyVector* WLS_Conversion_Efficiency=
-	 aMaterialPropertiesTable->GetProperty("WLSCONVEFFICIENCY");
-       if (WLS_Conversion_Efficiency) {
-	 const G4DynamicParticle* particle = track.GetDynamicParticle();
-
-	 G4double thePhotonEnergy = particle->GetTotalEnergy();
-	 G4double conversion_efficiency =
-	   WLS_Conversion_Efficiency->Value(thePhotonEnergy);
-
-	 // If the photon has zero conversion efficiency, it must not enter the process at all.
-	 if (conversion_efficiency == 0.) {
-	   return AttenuationLength;
-	 }
-	 // ParticleChange_->SetNumberOfSecondaries(1);
-	 AttenuationLength = DBL_MIN;
-       }
-     }
-
-     return AttenuationLength;
+    G4int materialIndex = track.GetMaterial()->GetIndex();
+    if (materialIndex >= (G4int)conv_efficiency_.size())
+      return AttenuationLength;
+
+    G4MaterialPropertyVector* WLS_Conversion_Efficiency =
+      conv_efficiency_[materialIndex];
+    if (WLS_Conversion_Efficiency) {
+      G4double thePhotonEnergy = track.GetDynamicParticle()->GetTotalEnergy();
+      G4double conversion_efficiency =
+	WLS_Conversion_Efficiency->Value(thePhotonEnergy);
+
+      // If the photon has zero conversion efficiency, it must not enter the process at all.
+      if (conversion_efficiency == 0.) {
+	return AttenuationLength;
+      }
+      AttenuationLength = DBL_MIN;
+    }
+
+    return AttenuationLength;
   }
 
   void WavelengthShifting::ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf,
@@ -13,6 +13,7 @@
 #define WLS_H
 
 #include <G4VDiscreteProcess.hh>
+#include <vector>
 
 class G4ParticleChange;
 class G4VWLSTimeGeneratorProfile;
@@ -31,6 +32,9 @@ namespace nexus {
     G4VParticleChange* PostStepDoIt(const G4Track& aTrack, const G4Step& aStep);
     G4double GetMeanFreePath(const G4Track& track, G4double, G4ForceCondition*);
 
+    /// Caches, per material index, the WLS properties used at every step
+    void BuildPhysicsTable(const G4ParticleDefinition&);
+
   private:
     void BuildThePhysicsTable();
     void ComputeCumulativeDistribution(const G4MaterialPropertyVector& pdf, G4PhysicsOrderedFreeVector& cdf);
@@ -40,6 +44,12 @@ namespace nexus {
     G4PhysicsTable* wlsIntegralTable_;
     G4VWLSTimeGeneratorProfile*  WLSTimeGeneratorProfile_;
 
+    /// WLSCONVEFFICIENCY of each material, indexed by material index.
+    /// A null pointer means that the material does not shift light.
+    std::vector<G4MaterialPropertyVector*> conv_efficiency_;
+    /// WLSTIMECONSTANT of each material, indexed by material index
+    std::vector<G4double> wls_time_;
+
   };
 
 }
@@ -14,6 +14,10 @@
 #include "Electroluminescence.h"
 #include "WavelengthShifting.h"
 #include "OpPhotoelectricEffect.h"
+#include "PhotonThinning.h"
+#include "S1Parametrisation.h"
+#include "RangeKiller.h"
+#include "OpticalTermination.h"
 
 #include <G4GenericMessenger.hh>
 #include <G4OpticalPhoton.hh>
@@ -21,6 +25,8 @@
 #include <G4ProcessTable.hh>
 #include <G4StepLimiter.hh>
 #include <G4FastSimulationManagerProcess.hh>
+#include <G4Region.hh>
+#include <G4RegionStore.hh>
 #include <G4PhysicsConstructorFactory.hh>
 
 
@@ -34,7 +40,9 @@ namespace nexus {
 
   NexusPhysics::NexusPhysics():
     G4VPhysicsConstructor("NexusPhysics"),
-    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false)
+    clustering_(true), drift_(true), electroluminescence_(true), photoelectric_(false),
+    kill_energy_(0.), optical_max_reflections_(0),
+    optical_max_length_(0.), optical_max_time_(0.)
   {
     msg_ = new G4GenericMessenger(this, "/PhysicsList/Nexus/",
       "Control commands of the nexus physics list.");
@@ -51,6 +59,39 @@ namespace nexus {
     msg_->DeclareProperty("photoelectric", photoelectric_,
       "Switch on/off the photoelectric effect.");
 
+    G4GenericMessenger::Command& survival_cmd =
+      msg_->DeclareMethod("photon_survival", &NexusPhysics::SetPhotonSurvival,
+        "Fraction of EL and scintillation photons generated. Sensor efficiencies are divided by it.");
+    survival_cmd.SetParameterName("photon_survival", false);
+    survival_cmd.SetRange("photon_survival>0. && photon_survival<=1.");
+
+    msg_->DeclareMethod("s1_table", &NexusPhysics::AddS1Table,
+      "Add an S1 light table. If any, S1 light is parametrised instead of generated.");
+
+    msg_->DeclareMethod("kill_volume", &NexusPhysics::AddKillVolume,
+      "Add a passive logical volume where particles that cannot reach a target are killed.");
+
+    msg_->DeclareMethod("kill_target", &NexusPhysics::AddKillTarget,
+      "Add a target (active or sensitive) logical volume for the range rejection.");
+
+    G4GenericMessenger::Command& kill_energy_cmd =
+      msg_->DeclarePropertyWithUnit("kill_energy", "keV", kill_energy_,
+        "Kinetic energy below which any particle is killed in the passive volumes.");
+    kill_energy_cmd.SetParameterName("kill_energy", false);
+    kill_energy_cmd.SetRange("kill_energy>=0.");
+
+    msg_->DeclareProperty("optical_max_reflections", optical_max_reflections_,
+      "Kill optical photons after this number of boundary reflections (0 for no limit).");
+
+    msg_->DeclarePropertyWithUnit("optical_max_length", "mm", optical_max_length_,
+      "Kill optical photons longer than this path length (0 for no limit).");
+
+    msg_->DeclarePropertyWithUnit("optical_max_time", "ns", optical_max_time_,
+      "Kill optical photons this time after their creation (0 for no limit).");
+
+    msg_->DeclareMethod("optical_kill_volume", &NexusPhysics::AddOpticalKillVolume,
+      "Add a logical volume where optical photons are killed when they enter it.");
+
   }
 
 
@@ -129,9 +170,72 @@ namespace nexus {
       }
     }
 
+    // Add parametrised S1 response to all pertinent particles
+
+    if (!s1_tables_.empty()) {
+
+      S1Parametrisation* s1 = new S1Parametrisation(s1_tables_);
+
+      auto aParticleIterator = GetParticleIterator();
+      aParticleIterator->reset();
+      while ((*aParticleIterator)()) {
+        G4ParticleDefinition* particle = aParticleIterator->value();
+        pmanager = particle->GetProcessManager();
+
+        if (s1->IsApplicable(*particle)) {
+          pmanager->AddDiscreteProcess(s1);
+          pmanager->AddRestProcess(s1);
+        }
+      }
+    }
+
+    // Add termination of particles in passive volumes
+
+    if (!kill_volumes_.empty()) {
+
+      RangeKiller* killer = new RangeKiller(kill_volumes_, kill_targets_, kill_energy_);
+
+      auto aParticleIterator = GetParticleIterator();
+      aParticleIterator->reset();
+      while ((*aParticleIterator)()) {
+        G4ParticleDefinition* particle = aParticleIterator->value();
+        pmanager = particle->GetProcessManager();
+
+        if (pmanager && killer->IsApplicable(*particle))
+          pmanager->AddDiscreteProcess(killer);
+      }
+    }
+
+    // Add termination policies to optical photons
+
+    if (optical_max_reflections_ > 0 || optical_max_length_ > 0. ||
+        optical_max_time_ > 0. || !optical_kill_volumes_.empty()) {
+      OpticalTermination* termination =
+        new OpticalTermination(optical_max_reflections_, optical_max_length_,
+                               optical_max_time_, optical_kill_volumes_);
+      pmanager = G4OpticalPhoton::Definition()->GetProcessManager();
+      pmanager->AddDiscreteProcess(termination);
+    }
+
+    // Add fast simulation to optical photons if any region of the
+    // geometry has fast simulation models (e.g., the light transport
+    // along fibers), so that they are invoked
+
+    for (auto region: *G4RegionStore::GetInstance()) {
+      if (region->GetFastSimulationManager()) {
+        pmanager = G4OpticalPhoton::Definition()->GetProcessManager();
+        pmanager->AddDiscreteProcess(new G4FastSimulationManagerProcess());
+        break;
+      }
+    }
+
     // Add photoelectric effect to optical photons
 
     if (photoelectric_) {
+      if (PhotonThinning::IsEnabled())
+        G4Exception("[NexusPhysics]", "ConstructProcess()", JustWarning,
+          "Photon thinning reduces the number of photoelectrons produced by the photoelectric effect.");
+
       OpPhotoelectricEffect* photoe = new OpPhotoelectricEffect();
 
       auto aParticleIterator = GetParticleIterator();
@@ -147,4 +251,34 @@ namespace nexus {
     }
   }
 
+
+  void NexusPhysics::SetPhotonSurvival(G4double survival)
+  {
+    PhotonThinning::SetSurvivalFactor(survival);
+  }
+
+
+  void NexusPhysics::AddS1Table(G4String filename)
+  {
+    s1_tables_.push_back(filename);
+  }
+
+
+  void NexusPhysics::AddKillVolume(G4String name)
+  {
+    kill_volumes_.push_back(name);
+  }
+
+
+  void NexusPhysics::AddKillTarget(G4String name)
+  {
+    kill_targets_.push_back(name);
+  }
+
+
+  void NexusPhysics::AddOpticalKillVolume(G4String name)
+  {
+    optical_kill_volumes_.push_back(name);
+  }
+
 } // end namespace nexus
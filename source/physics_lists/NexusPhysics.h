@@ -11,6 +11,8 @@
 
 #include <G4VPhysicsConstructor.hh>
 
+#include <vector>
+
 class G4GenericMessenger;
 
 
@@ -29,12 +31,37 @@ namespace nexus {
     /// Construct all required physics processes (Geant4 mandatory method)
     virtual void ConstructProcess();
 
+  private:
+    /// Set the fraction of EL and scintillation photons
+    /// that are generated (see PhotonThinning)
+    void SetPhotonSurvival(G4double);
+    /// Add an S1 light table, enabling the parametrised S1 response
+    void AddS1Table(G4String);
+    /// Add a passive volume where particles are killed (see RangeKiller)
+    void AddKillVolume(G4String);
+    /// Add a target volume for the range rejection (see RangeKiller)
+    void AddKillTarget(G4String);
+    /// Add a volume where optical photons are killed (see OpticalTermination)
+    void AddOpticalKillVolume(G4String);
+
   private:
     G4bool clustering_;          ///< Switch on/of the ionization clustering
     G4bool drift_;               ///< Switch on/of the ionization drift
     G4bool electroluminescence_; ///< Switch on/off the electroluminescence
     G4bool photoelectric_;       ///< Switch on/off the photoelectric effect
 
+    std::vector<G4String> s1_tables_; ///< S1 light tables (see S1Parametrisation)
+
+    std::vector<G4String> kill_volumes_; ///< Passive volumes (see RangeKiller)
+    std::vector<G4String> kill_targets_; ///< Target volumes (see RangeKiller)
+    G4double kill_energy_; ///< Energy below which particles are killed in passive volumes
+
+    // Termination policies of optical photons (see OpticalTermination)
+    G4int optical_max_reflections_;
+    G4double optical_max_length_;
+    G4double optical_max_time_;
+    std::vector<G4String> optical_kill_volumes_;
+
     G4GenericMessenger* msg_;
   };
 
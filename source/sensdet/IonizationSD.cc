@@ -2,6 +2,9 @@
 // nexus | IonizationSD.cc
 //
 // This class is the sensitive detector that creates ionization hits.
+// Optionally, the energy deposits can be merged into voxels (and time
+// slices), either per track or per event, with the hit placed at the
+// energy-weighted centroid of the deposits.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -16,12 +19,21 @@
 #include <G4SDManager.hh>
 #include <G4Step.hh>
 #include <G4OpticalPhoton.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <cmath>
 
 
 
 using namespace nexus;
 
 
+IonizationSD::MergeMode IonizationSD::merge_mode_ = IonizationSD::NONE;
+G4double IonizationSD::voxel_xy_   = 1. * mm;
+G4double IonizationSD::voxel_z_    = 1. * mm;
+G4double IonizationSD::time_slice_ = 0.;
+
+
 
 IonizationSD::IonizationSD(const G4String& name):
   G4VSensitiveDetector(name), include_(true)
@@ -57,6 +69,62 @@ void IonizationSD::Initialize(G4HCofThisEvent* hce)
     G4SDManager::GetSDMpointer()->GetCollectionID(SensitiveDetectorName+"/"+collectionName[0]);
   hce->AddHitsCollection(hcid, IHC_);
 
+  // Clearing keeps the buckets, so the map is
+  // only allocated once its size stabilises
+  voxels_.clear();
+}
+
+
+
+void IonizationSD::SetMergeMode(const G4String& mode)
+{
+  if      (mode == "none")  merge_mode_ = NONE;
+  else if (mode == "track") merge_mode_ = TRACK;
+  else if (mode == "event") merge_mode_ = EVENT;
+  else
+    G4Exception("[IonizationSD]", "SetMergeMode()", FatalException,
+                ("Unknown merge mode " + mode + ". Use none, track or event.").c_str());
+}
+
+
+
+void IonizationSD::SetVoxelSizeXY(G4double size)
+{
+  if (size <= 0.)
+    G4Exception("[IonizationSD]", "SetVoxelSizeXY()", FatalException,
+                "The voxel size must be positive.");
+  voxel_xy_ = size;
+}
+
+
+
+void IonizationSD::SetVoxelSizeZ(G4double size)
+{
+  if (size <= 0.)
+    G4Exception("[IonizationSD]", "SetVoxelSizeZ()", FatalException,
+                "The voxel size must be positive.");
+  voxel_z_ = size;
+}
+
+
+
+void IonizationSD::SetTimeSlice(G4double slice)
+{
+  if (slice < 0.)
+    G4Exception("[IonizationSD]", "SetTimeSlice()", FatalException,
+                "The time slice cannot be negative.");
+  time_slice_ = slice;
+}
+
+
+
+int64_t IonizationSD::BinIndex(G4double x, G4double width)
+{
+  const G4double limit = 4.e18; // Well within the range of int64_t
+  G4double index = std::floor(x / width);
+  if (index >  limit) return  int64_t(limit);
+  if (index < -limit) return -int64_t(limit);
+  return int64_t(index);
 }
 
 
@@ -74,15 +142,46 @@ G4bool IonizationSD::ProcessHits(G4Step* step, G4TouchableHistory*)
   // Discard steps where no energy was deposited in the detector
   if (edep <= 0.) return false;
 
-  // Create a hit and set its properties
-  IonizationHit* hit = new IonizationHit();
-  hit->SetTrackID(step->GetTrack()->GetTrackID());
-  hit->SetTime(step->GetTrack()->GetGlobalTime());
-  hit->SetEnergyDeposit(edep);
-  hit->SetPosition(step->GetPostStepPoint()->GetPosition());
+  G4int track_id = step->GetTrack()->GetTrackID();
+  G4double time = step->GetTrack()->GetGlobalTime();
+  G4ThreeVector position = step->GetPostStepPoint()->GetPosition();
+
+  IonizationHit* hit = 0;
+
+  if (merge_mode_ != NONE) {
+    VoxelKey key;
+    key.ix = BinIndex(position.x(), voxel_xy_);
+    key.iy = BinIndex(position.y(), voxel_xy_);
+    key.iz = BinIndex(position.z(), voxel_z_);
+    key.it = (time_slice_ > 0.) ? BinIndex(time, time_slice_) : 0;
+    key.track_id = (merge_mode_ == TRACK) ? track_id : 0;
+
+    auto result = voxels_.insert(std::make_pair(key, (size_t) IHC_->entries()));
+    if (!result.second) {
+      // Move the hit of the voxel to the energy-weighted
+      // centroid (in space and time) of its deposits.
+      // In event mode, the hit keeps the ID of the first
+      // track that deposited energy in the voxel.
+      hit = (*IHC_)[result.first->second];
+      G4double energy = hit->GetEnergyDeposit() + edep;
+      G4double w = edep / energy;
+      hit->SetPosition(hit->GetPosition() + w * (position - hit->GetPosition()));
+      hit->SetTime(hit->GetTime() + w * (time - hit->GetTime()));
+      hit->SetEnergyDeposit(energy);
+    }
+  }
 
-  // Add hit to collection
-  IHC_->insert(hit);
+  if (!hit) {
+    // Create a hit and set its properties
+    hit = new IonizationHit();
+    hit->SetTrackID(track_id);
+    hit->SetTime(time);
+    hit->SetEnergyDeposit(edep);
+    hit->SetPosition(position);
+
+    // Add hit to collection
+    IHC_->insert(hit);
+  }
 
   // Add energy deposit to the trajectory associated
   // to the current track
@@ -2,6 +2,9 @@
 // nexus | IonizationSD.h
 //
 // This class is the sensitive detector that creates ionization hits.
+// Optionally, the energy deposits can be merged into voxels (and time
+// slices), either per track or per event, with the hit placed at the
+// energy-weighted centroid of the deposits.
 //
 // The NEXT Collaboration
 // ----------------------------------------------------------------------------
@@ -12,6 +15,9 @@
 #include <G4VSensitiveDetector.hh>
 #include "IonizationHit.h"
 
+#include <unordered_map>
+#include <cstdint>
+
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
@@ -42,14 +48,62 @@ namespace nexus {
 
     void IncludeInTotalEnergyDeposit(G4bool);
 
+    /// Set how deposits are merged in all ionization SDs:
+    /// "none" (one hit per step), "track" or "event"
+    static void SetMergeMode(const G4String&);
+    /// Set the voxel size used for merging in the xy plane
+    static void SetVoxelSizeXY(G4double);
+    /// Set the voxel size used for merging along z
+    static void SetVoxelSizeZ(G4double);
+    /// Set the duration of the time slices used for merging
+    /// (0 means deposits are merged regardless of their time)
+    static void SetTimeSlice(G4double);
+
   private:
     ///
     virtual G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
+    enum MergeMode { NONE, TRACK, EVENT };
+
+    /// Voxel (and time slice) of a deposit. The track ID
+    /// is zero when merging deposits of the whole event.
+    /// The indices are 64-bit, since the time of deposits of
+    /// long-lived decays easily exceeds 2^31 time slices.
+    struct VoxelKey {
+      int64_t ix, iy, iz, it;
+      G4int track_id;
+      bool operator==(const VoxelKey& k) const
+      { return ix == k.ix && iy == k.iy && iz == k.iz && it == k.it && track_id == k.track_id; }
+    };
+
+    struct VoxelKeyHash {
+      size_t operator()(const VoxelKey& k) const
+      {
+        size_t h = std::hash<int64_t>()(k.ix);
+        h = h * 1000003 ^ std::hash<int64_t>()(k.iy);
+        h = h * 1000003 ^ std::hash<int64_t>()(k.iz);
+        h = h * 1000003 ^ std::hash<int64_t>()(k.it);
+        h = h * 1000003 ^ std::hash<G4int>()(k.track_id);
+        return h;
+      }
+    };
+
+    /// Index of the bin of the given width containing x, clamped
+    /// to the range of the key for very large values
+    static int64_t BinIndex(G4double x, G4double width);
+
   private:
     IonizationHitsCollection* IHC_;
     G4String det_name_;
     G4bool include_;
+
+    /// Index in the hits collection of the hit of each voxel
+    std::unordered_map<VoxelKey, size_t, VoxelKeyHash> voxels_;
+
+    static MergeMode merge_mode_;
+    static G4double voxel_xy_;
+    static G4double voxel_z_;
+    static G4double time_slice_;
   };
 
   inline void IonizationSD::IncludeInTotalEnergyDeposit(G4bool inc)
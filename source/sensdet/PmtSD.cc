@@ -8,13 +8,13 @@
 // ----------------------------------------------------------------------------
 
 #include "PmtSD.h"
+#include "SensorRegistry.h"
 
 #include <G4OpticalPhoton.hh>
 #include <G4SDManager.hh>
 #include <G4ProcessManager.hh>
 #include <G4OpBoundaryProcess.hh>
 #include <G4RunManager.hh>
-#include <G4RunManager.hh>
 
 
 namespace nexus {
@@ -53,6 +53,9 @@ namespace nexus {
       GetCollectionID(this->GetName()+"/"+this->GetCollectionName(0));
 
     HCE->AddHitsCollection(HCID, HC_);
+
+    hits_by_slot_.assign(SensorRegistry::GetNumberOfSensors(), nullptr);
+    unregistered_hits_.clear();
   }
 
 
@@ -86,24 +89,7 @@ namespace nexus {
 	  step->GetPostStepPoint()->GetTouchable();
 
 	G4int pmt_id = FindPmtID(touchable);
-
- 	PmtHit* hit = 0;
-	for (size_t i=0; i<HC_->entries(); i++) {
- 	  if ((*HC_)[i]->GetPmtID() == pmt_id) {
- 	    hit = (*HC_)[i];
-	    break;
-	  }
- 	}
-
- 	// If no hit associated to this sensor exists already,
- 	// create it and set main properties
- 	if (!hit) {
- 	  hit = new PmtHit();
- 	  hit->SetPmtID(pmt_id);
- 	  hit->SetBinSize(timebinning_);
- 	  hit->SetPosition(touchable->GetTranslation());
- 	  HC_->insert(hit);
- 	}
+	PmtHit* hit = GetHit(pmt_id, touchable);
 
  	G4double time = step->GetPostStepPoint()->GetGlobalTime();
  	hit->Fill(time);
@@ -115,6 +101,46 @@ namespace nexus {
 
 
 
+  void PmtSD::AddDetectedPhotons(G4int pmt_id, G4double time, G4int counts)
+  {
+    GetHit(pmt_id)->Fill(time, counts);
+  }
+
+
+
+  PmtHit* PmtSD::GetHit(G4int pmt_id, const G4VTouchable* touchable)
+  {
+    G4int slot = SensorRegistry::GetSlot(pmt_id);
+
+    PmtHit* hit = 0;
+    if (slot >= 0) {
+      hit = hits_by_slot_[slot];
+    } else {
+      auto it = unregistered_hits_.find(pmt_id);
+      if (it != unregistered_hits_.end()) hit = it->second;
+    }
+
+    if (hit) return hit;
+
+    // If no hit associated to this sensor exists already,
+    // create it and set main properties
+    hit = new PmtHit();
+    hit->SetPmtID(pmt_id);
+    hit->SetBinSize(timebinning_);
+    if (slot >= 0) {
+      hit->SetPosition(SensorRegistry::GetSensor(slot).position);
+      hits_by_slot_[slot] = hit;
+    } else {
+      if (touchable) hit->SetPosition(touchable->GetTranslation());
+      unregistered_hits_[pmt_id] = hit;
+    }
+    HC_->insert(hit);
+
+    return hit;
+  }
+
+
+
   G4int PmtSD::FindPmtID(const G4VTouchable* touchable)
   {
     G4int pmtid = touchable->GetCopyNumber(sensor_depth_);
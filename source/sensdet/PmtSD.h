@@ -13,6 +13,9 @@
 #include <G4VSensitiveDetector.hh>
 #include "PmtHit.h"
 
+#include <vector>
+#include <unordered_map>
+
 class G4Step;
 class G4HCofThisEvent;
 class G4VTouchable;
@@ -62,12 +65,22 @@ namespace nexus {
     /// persistency manager to select the collection.
     static G4String GetCollectionUniqueName();
 
+    /// Records photons detected by a sensor without tracking them
+    /// (used by parametrised light response models). Must be invoked
+    /// during the event, after the initialization of the detector.
+    void AddDetectedPhotons(G4int pmt_id, G4double time, G4int counts=1);
+
   private:
 
     G4bool ProcessHits(G4Step*, G4TouchableHistory*);
 
     G4int FindPmtID(const G4VTouchable*);
 
+    /// Returns the hit of the sensor in the current event, creating it if
+    /// needed. The touchable, if given, is used to position sensors
+    /// not present in the registry.
+    PmtHit* GetHit(G4int pmt_id, const G4VTouchable* touchable=0);
+
     G4int naming_order_; ///< Order of the naming scheme
     G4int sensor_depth_; ///< Depth of the SD in the geometry tree
     G4int mother_depth_; ///< Depth of the SD's mother in the geometry tree
@@ -77,6 +90,11 @@ namespace nexus {
     G4OpBoundaryProcess* boundary_; ///< Pointer to the optical boundary process
 
     PmtHitsCollection* HC_; ///< Pointer to the collection of hits
+
+    /// Hits of the event indexed by the slot of the sensor in the registry
+    std::vector<PmtHit*> hits_by_slot_;
+    /// Hits of the event of sensors not present in the registry
+    std::unordered_map<G4int, PmtHit*> unregistered_hits_;
   };
 
   // INLINE METHODS //////////////////////////////////////////////////
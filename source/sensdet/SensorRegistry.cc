@@ -0,0 +1,132 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorRegistry.cc
+//
+// This class is a container of the photosensors of the geometry. Sensors are
+// registered by the geometries at construction time, so that their ID, name,
+// position and time binning are known before any photon is detected.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#include "SensorRegistry.h"
+
+#include <G4LogicalVolume.hh>
+#include <G4VPhysicalVolume.hh>
+#include <G4Transform3D.hh>
+#include <G4Point3D.hh>
+
+#include <map>
+#include <set>
+
+
+std::vector<nexus::SensorInfo> nexus::SensorRegistry::sensors_;
+std::unordered_map<G4int, G4int> nexus::SensorRegistry::slots_;
+
+
+namespace {
+
+  typedef std::map<const G4LogicalVolume*, G4Transform3D> FrameMap;
+
+  // Walk down the volume tree accumulating transformations until
+  // the global transformation of all the requested frames is known.
+  void FindFrames(const G4VPhysicalVolume* pv, const G4Transform3D& parent,
+                  const std::set<const G4LogicalVolume*>& requested,
+                  FrameMap& frames)
+  {
+    G4Transform3D transform =
+      parent * G4Transform3D(pv->GetObjectRotationValue(),
+                             pv->GetObjectTranslation());
+
+    const G4LogicalVolume* lv = pv->GetLogicalVolume();
+    if (requested.count(lv) && !frames.count(lv))
+      frames.insert(std::make_pair(lv, transform));
+
+    for (size_t i=0; i<lv->GetNoDaughters(); ++i) {
+      if (frames.size() == requested.size()) return;
+      const G4VPhysicalVolume* daughter = lv->GetDaughter(i);
+      // Replicated volumes do not host sensor frames
+      if (daughter->IsReplicated()) continue;
+      FindFrames(daughter, transform, requested, frames);
+    }
+  }
+
+}
+
+
+namespace nexus {
+
+  SensorRegistry::SensorRegistry()
+  {
+  }
+
+
+
+  SensorRegistry::~SensorRegistry()
+  {
+    Clear();
+  }
+
+
+
+  void SensorRegistry::Register(G4int id, const G4String& name,
+                                const G4ThreeVector& position, G4double binning,
+                                const G4LogicalVolume* frame)
+  {
+    if (slots_.find(id) != slots_.end()) {
+      G4String msg = "Sensor ID " + std::to_string(id) +
+        " registered more than once. Keeping the first one.";
+      G4Exception("[SensorRegistry]", "Register()", JustWarning, msg.c_str());
+      return;
+    }
+
+    SensorInfo sensor;
+    sensor.id       = id;
+    sensor.name     = name;
+    sensor.position = position;
+    sensor.binning  = binning;
+    sensor.frame    = frame;
+
+    slots_[id] = sensors_.size();
+    sensors_.push_back(sensor);
+  }
+
+
+
+  void SensorRegistry::ResolveGlobalPositions(const G4VPhysicalVolume* world)
+  {
+    std::set<const G4LogicalVolume*> requested;
+    for (auto& sensor: sensors_)
+      if (sensor.frame) requested.insert(sensor.frame);
+
+    if (requested.empty()) return;
+
+    FrameMap frames;
+    FindFrames(world, G4Transform3D(), requested, frames);
+
+    for (auto& sensor: sensors_) {
+      if (!sensor.frame) continue;
+
+      FrameMap::const_iterator it = frames.find(sensor.frame);
+      if (it == frames.end()) {
+        G4String msg = "Reference volume of sensor " + std::to_string(sensor.id) +
+          " not found in the geometry. Its position is left in local coordinates.";
+        G4Exception("[SensorRegistry]", "ResolveGlobalPositions()",
+                    JustWarning, msg.c_str());
+        continue;
+      }
+
+      G4Point3D global = it->second * G4Point3D(sensor.position);
+      sensor.position = G4ThreeVector(global.x(), global.y(), global.z());
+      sensor.frame = nullptr;
+    }
+  }
+
+
+
+  void SensorRegistry::Clear()
+  {
+    sensors_.clear();
+    slots_.clear();
+  }
+
+} // namespace nexus
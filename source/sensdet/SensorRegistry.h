@@ -0,0 +1,95 @@
+// ----------------------------------------------------------------------------
+// nexus | SensorRegistry.h
+//
+// This class is a container of the photosensors of the geometry. Sensors are
+// registered by the geometries at construction time, so that their ID, name,
+// position and time binning are known before any photon is detected.
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef SENSOR_REGISTRY_H
+#define SENSOR_REGISTRY_H
+
+#include <G4ThreeVector.hh>
+#include <globals.hh>
+
+#include <vector>
+#include <unordered_map>
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+
+
+namespace nexus {
+
+  struct SensorInfo
+  {
+    G4int id;               ///< Sensor ID, as computed by PmtSD
+    G4String name;          ///< Name of the sensitive detector
+    G4ThreeVector position; ///< Position (global once resolved)
+    G4double binning;       ///< Time binning of the sensor
+    const G4LogicalVolume* frame; ///< Volume where the position is given
+  };
+
+
+  class SensorRegistry
+  {
+  public:
+    /// Register a sensor. The position is given in the reference frame
+    /// of the logical volume frame (or in global coordinates if null).
+    static void Register(G4int id, const G4String& name,
+                         const G4ThreeVector& position, G4double binning,
+                         const G4LogicalVolume* frame=nullptr);
+
+    /// Transform the positions of all sensors to global coordinates.
+    /// Invoked once the world volume has been constructed.
+    static void ResolveGlobalPositions(const G4VPhysicalVolume* world);
+
+    /// Return the slot of a sensor given its ID, or -1 if not registered
+    static G4int GetSlot(G4int id);
+
+    /// Return the information of the sensor in a given slot
+    static const SensorInfo& GetSensor(G4int slot);
+
+    /// Return the number of registered sensors
+    static G4int GetNumberOfSensors();
+
+    /// Return all registered sensors
+    static const std::vector<SensorInfo>& GetSensors();
+
+    /// Remove all sensors from the registry
+    static void Clear();
+
+  private:
+    // Constructors, destructor and assignement op are hidden
+    // so that no instance of the class can be created.
+    SensorRegistry();
+    SensorRegistry(const SensorRegistry&);
+    ~SensorRegistry();
+
+  private:
+    static std::vector<SensorInfo> sensors_;
+    static std::unordered_map<G4int, G4int> slots_;
+  };
+
+  // INLINE DEFINITIONS //////////////////////////////////////////////
+
+  inline G4int SensorRegistry::GetSlot(G4int id)
+  {
+    auto it = slots_.find(id);
+    return (it == slots_.end()) ? -1 : it->second;
+  }
+
+  inline const SensorInfo& SensorRegistry::GetSensor(G4int slot)
+  { return sensors_[slot]; }
+
+  inline G4int SensorRegistry::GetNumberOfSensors()
+  { return sensors_.size(); }
+
+  inline const std::vector<SensorInfo>& SensorRegistry::GetSensors()
+  { return sensors_; }
+
+} // namespace nexus
+
+#endif
@@ -0,0 +1,61 @@
+// ----------------------------------------------------------------------------
+// nexus | MicroBenchmark.h
+//
+// Minimal timing harness for the micro-benchmarks of nexus-test.
+// Benchmarks are hidden test cases tagged [.benchmark], so that they only
+// run when requested explicitly:  nexus-test "[benchmark]"
+//
+// The NEXT Collaboration
+// ----------------------------------------------------------------------------
+
+#ifndef MICRO_BENCHMARK_H
+#define MICRO_BENCHMARK_H
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+namespace nexus {
+
+  /// Prevents the compiler from optimising away a computed value
+  template <typename T>
+  inline void DoNotOptimize(const T& value)
+  {
+    asm volatile("" : : "g"(&value) : "memory");
+  }
+
+  /// Runs fn a number of times per sample (after a warm-up) and prints
+  /// the median and minimum time per call over all samples
+  template <typename F>
+  void MicroBenchmark(const std::string& name, long iterations, F fn,
+                      int samples=7)
+  {
+    typedef std::chrono::steady_clock Clock;
+
+    for (long i=0; i<iterations/10+1; ++i) fn();
+
+    std::vector<double> ns_per_op;
+    for (int s=0; s<samples; ++s) {
+      Clock::time_point start = Clock::now();
+      for (long i=0; i<iterations; ++i) fn();
+      std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+      ns_per_op.push_back(elapsed.count() / iterations);
+    }
+
+    std::sort(ns_per_op.begin(), ns_per_op.end());
+
+    std::cout << std::left << std::setw(56) << name << std::right
+              << std::fixed << std::setprecision(2)
+              << " median " << std::setw(10) << ns_per_op[samples/2] << " ns/op"
+              << "   min " << std::setw(10) << ns_per_op[0] << " ns/op"
+              << "   (" << samples << " x " << iterations << ")"
+              << std::defaultfloat << std::endl;
+  }
+
+} // end namespace nexus
+
+#endif
@@ -0,0 +1,25 @@
+#include <XenonGasProperties.h>
+#include <MicroBenchmark.h>
+
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("XenonGasProperties::GetDensity", "[.benchmark]") {
+  // Requires NEXUSDIR to locate the density table
+
+  nexus::XenonGasProperties props;
+
+  std::vector<std::pair<G4double, G4double>> points(4096);
+  for (auto& p: points)
+    p = std::make_pair((1. + 28. * G4UniformRand()) * bar,
+                       (274. + 40. * G4UniformRand()) * kelvin);
+
+  size_t i = 0;
+  nexus::MicroBenchmark("XenonGasProperties::GetDensity", 100000, [&]() {
+      const auto& p = points[i++ & 4095];
+      nexus::DoNotOptimize(props.GetDensity(p.first, p.second));
+    });
+}
@@ -0,0 +1,40 @@
+#include <HDF5Writer.h>
+#include <MicroBenchmark.h>
+
+#include <cstdio>
+
+#include <catch.hpp>
+
+
+TEST_CASE("HDF5Writer per-row writes", "[.benchmark]") {
+  // Each call appends one row to the corresponding table
+
+  std::string filename = "nexus_bench_writer.h5";
+  nexus::HDF5Writer writer;
+  writer.Open(filename, false);
+
+  int evt = 0;
+  unsigned int sensor = 0;
+
+  nexus::MicroBenchmark("HDF5Writer::WriteSensorDataInfo", 20000, [&]() {
+      writer.WriteSensorDataInfo(evt, sensor & 1023, sensor & 255, 1);
+      ++sensor;
+    }, 5);
+
+  int hit = 0;
+  nexus::MicroBenchmark("HDF5Writer::WriteHitInfo", 20000, [&]() {
+      writer.WriteHitInfo(evt, 1, hit++, 1.f, 2.f, 3.f, 4.f, .01f, "ACTIVE");
+    }, 5);
+
+  int particle = 0;
+  nexus::MicroBenchmark("HDF5Writer::WriteParticleInfo", 20000, [&]() {
+      writer.WriteParticleInfo(evt, particle++, "e-", 0, 1,
+                               0.f, 0.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f,
+                               "ACTIVE", "ACTIVE",
+                               0.f, 0.f, 1.f, 0.f, 0.f, 0.f,
+                               1.f, 1.f, "eIoni", "eIoni");
+    }, 5);
+
+  writer.Close();
+  std::remove(filename.c_str());
+}
@@ -0,0 +1,73 @@
+#include <ELLookupTable.h>
+#include <UniformElectricDriftField.h>
+#include <SegmentPointSampler.h>
+#include <MicroBenchmark.h>
+
+#include <G4SystemOfUnits.hh>
+#include <G4LorentzVector.hh>
+#include <Randomize.hh>
+
+#include <cstdio>
+#include <fstream>
+
+#include <catch.hpp>
+
+
+TEST_CASE("ELLookupTable::GetSensorsMap", "[.benchmark]") {
+  // Small table with 1200 EL points and 16 sensors per point,
+  // enough to cover the 92.5 mm radius grid assumed by the class
+
+  G4String filename = "nexus_bench_ELtable.txt";
+  std::ofstream file(filename);
+  file << "* micro-benchmark fixture\n\n";
+  for (G4int point=0; point<1200; ++point)
+    for (G4int sensor=0; sensor<16; ++sensor)
+      file << point << " " << sensor << " .1 .2 .3 .2 .1\n";
+  file.close();
+
+  nexus::ELLookupTable table(filename);
+  std::remove(filename.c_str());
+
+  std::vector<G4ThreeVector> points(4096);
+  for (auto& p: points) {
+    G4double r   = 90. * mm * std::sqrt(G4UniformRand());
+    G4double phi = twopi * G4UniformRand();
+    p = G4ThreeVector(r * std::cos(phi), r * std::sin(phi), 0.);
+  }
+
+  size_t i = 0;
+  nexus::MicroBenchmark("ELLookupTable::GetSensorsMap", 100000, [&]() {
+      nexus::DoNotOptimize(table.GetSensorsMap(points[i++ & 4095]).size());
+    });
+}
+
+
+TEST_CASE("UniformElectricDriftField::Drift", "[.benchmark]") {
+  // Drift region of NEXT-100 size
+
+  nexus::UniformElectricDriftField field(0. * mm, 1200. * mm);
+  field.SetDriftVelocity(1. * mm/microsecond);
+  field.SetTransverseDiffusion(1. * mm/sqrt(cm));
+  field.SetLongitudinalDiffusion(.3 * mm/sqrt(cm));
+
+  std::vector<G4LorentzVector> origins(4096);
+  for (auto& o: origins)
+    o = G4LorentzVector(G4UniformRand() * 400. * mm, G4UniformRand() * 400. * mm,
+                        G4UniformRand() * 1200. * mm, 0.);
+
+  size_t i = 0;
+  nexus::MicroBenchmark("UniformElectricDriftField::Drift", 1000000, [&]() {
+      G4LorentzVector xyzt = origins[i++ & 4095];
+      nexus::DoNotOptimize(field.Drift(xyzt));
+    });
+}
+
+
+TEST_CASE("SegmentPointSampler::Shoot", "[.benchmark]") {
+  nexus::SegmentPointSampler sampler(G4LorentzVector(0., 0., 0., 0.),
+                                     G4LorentzVector(1. * mm, 2. * mm, 3. * mm, 1. * ns));
+
+  nexus::MicroBenchmark("SegmentPointSampler::Shoot", 1000000, [&]() {
+      nexus::DoNotOptimize(sampler.Shoot());
+    });
+}
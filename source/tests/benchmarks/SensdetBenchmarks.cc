@@ -0,0 +1,70 @@
+#include <PmtHit.h>
+#include <SensorRegistry.h>
+#include <MicroBenchmark.h>
+
+#include <G4SystemOfUnits.hh>
+#include <Randomize.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("PmtHit::Fill", "[.benchmark]") {
+  // Photon arrival times spread over a 1 ms event,
+  // filled in 1 microsecond bins
+
+  std::vector<G4double> times(4096);
+  for (auto& t: times) t = G4UniformRand() * ms;
+
+  nexus::PmtHit hit;
+  hit.SetBinSize(1. * microsecond);
+
+  size_t i = 0;
+  nexus::MicroBenchmark("PmtHit::Fill (1 us bins, 1 ms window)", 1000000, [&]() {
+      hit.Fill(times[i++ & 4095]);
+    });
+
+  REQUIRE(hit.GetHistogram().size() > 0);
+}
+
+
+TEST_CASE("PmtSD sensor lookup", "[.benchmark]") {
+  // Sensor IDs as in NEXT-100: 56 boards of 64 SiPMs plus 60 PMTs.
+  // The registry lookup is compared with a linear search over
+  // the hits of the event, as done before the registry existed.
+
+  nexus::SensorRegistry::Clear();
+  std::vector<G4int> ids;
+  for (G4int i=0; i<60; ++i) ids.push_back(i);
+  for (G4int b=1; b<=56; ++b)
+    for (G4int j=0; j<64; ++j) ids.push_back(1000*b + j);
+  for (auto id: ids)
+    nexus::SensorRegistry::Register(id, "SENSOR", G4ThreeVector(), 1.*microsecond);
+
+  std::vector<nexus::PmtHit*> hits;
+  for (auto id: ids) {
+    nexus::PmtHit* hit = new nexus::PmtHit();
+    hit->SetPmtID(id);
+    hits.push_back(hit);
+  }
+
+  std::vector<G4int> queries(4096);
+  for (auto& q: queries) q = ids[G4RandFlat::shootInt((long) ids.size())];
+
+  size_t i = 0;
+  nexus::MicroBenchmark("SensorRegistry::GetSlot", 1000000, [&]() {
+      nexus::DoNotOptimize(nexus::SensorRegistry::GetSlot(queries[i++ & 4095]));
+    });
+
+  i = 0;
+  nexus::MicroBenchmark("Linear search over hits (baseline)", 10000, [&]() {
+      G4int id = queries[i++ & 4095];
+      nexus::PmtHit* found = nullptr;
+      for (auto hit: hits)
+        if (hit->GetPmtID() == id) { found = hit; break; }
+      nexus::DoNotOptimize(found);
+    });
+
+  for (auto hit: hits) delete hit;
+  REQUIRE(nexus::SensorRegistry::GetNumberOfSensors() == (G4int) ids.size());
+  nexus::SensorRegistry::Clear();
+}
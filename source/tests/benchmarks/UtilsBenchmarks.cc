@@ -0,0 +1,33 @@
+#include <BoxPointSampler.h>
+#include <CylinderPointSampler2020.h>
+#include <MicroBenchmark.h>
+
+#include <G4SystemOfUnits.hh>
+
+#include <catch.hpp>
+
+
+TEST_CASE("CylinderPointSampler2020::GenerateVertex", "[.benchmark]") {
+  nexus::CylinderPointSampler2020 sampler(100. * mm, 110. * mm, 500. * mm);
+
+  nexus::MicroBenchmark("CylinderPointSampler2020 VOLUME", 1000000, [&]() {
+      nexus::DoNotOptimize(sampler.GenerateVertex("VOLUME"));
+    });
+
+  nexus::MicroBenchmark("CylinderPointSampler2020 INNER_SURFACE", 1000000, [&]() {
+      nexus::DoNotOptimize(sampler.GenerateVertex("INNER_SURFACE"));
+    });
+}
+
+
+TEST_CASE("BoxPointSampler::GenerateVertex", "[.benchmark]") {
+  nexus::BoxPointSampler sampler(100. * mm, 200. * mm, 300. * mm, 5. * mm);
+
+  nexus::MicroBenchmark("BoxPointSampler WHOLE_VOL", 1000000, [&]() {
+      nexus::DoNotOptimize(sampler.GenerateVertex("WHOLE_VOL"));
+    });
+
+  nexus::MicroBenchmark("BoxPointSampler INSIDE", 1000000, [&]() {
+      nexus::DoNotOptimize(sampler.GenerateVertex("INSIDE"));
+    });
+}
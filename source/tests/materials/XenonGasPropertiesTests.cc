@@ -22,6 +22,16 @@ TEST_CASE("XenonGasProperties::Density") {
     REQUIRE (density/(kg/m3) == target);
   }
 
+  SECTION ("Grid boundaries") {
+    REQUIRE (props.GetDensity( 0 * bar, 273 * kelvin)/(kg/m3) == Approx(0.));
+    REQUIRE (props.GetDensity(30 * bar, 314 * kelvin)/(kg/m3) == Approx(177.21));
+  }
+
+  SECTION ("Repeated lookups") {
+    G4double density = props.GetDensity(15 * bar, 295 * kelvin);
+    REQUIRE (props.GetDensity(15 * bar, 295 * kelvin) == density);
+  }
+
   SECTION ("Pressure is too big") {
     REQUIRE_THROWS (props.GetDensity(51 * bar, 295 * kelvin),
                     "Unknown xenon density for this pressure");
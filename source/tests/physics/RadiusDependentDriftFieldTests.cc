@@ -0,0 +1,104 @@
+#include <RadiusDependentDriftField.h>
+
+#include <G4LorentzVector.hh>
+#include <G4SystemOfUnits.hh>
+
+#include <fstream>
+#include <cstdio>
+#include <cmath>
+
+#include <catch.hpp>
+
+namespace {
+
+  // Writes a uniform field map pointing from the anode (z = 0)
+  // to the cathode (z = 100 mm), so electrons drift toward z = 0
+  // (and, for a negative er, away from the axis)
+  void WriteUniformFieldMap(const G4String& filename, G4int er=0)
+  {
+    std::ofstream out(filename);
+    out << "# r z Er Ez\n";
+    for (G4int ir=0; ir<=10; ++ir)
+      for (G4int iz=0; iz<=10; ++iz)
+        out << 10*ir << " " << 10*iz << " " << er << " 1\n";
+  }
+
+  void CheckDrift(nexus::RadiusDependentDriftField& field,
+                  G4double r, G4double z)
+  {
+    G4LorentzVector xyzt(r, 0., z, 0.);
+    G4double step = field.Drift(xyzt);
+
+    REQUIRE(step > 0.);
+    REQUIRE(xyzt.perp() == Approx(r).margin(1.e-3*mm));
+    REQUIRE(xyzt.z()    == Approx(0.).margin(1.e-2*mm));
+    REQUIRE(xyzt.t()    == Approx(z / field.GetDriftVelocity()).epsilon(1.e-4));
+  }
+}
+
+
+TEST_CASE("RadiusDependentDriftField") {
+
+  const G4String map_file   = "RadiusDependentDriftFieldTests.map.txt";
+  const G4String table_file = "RadiusDependentDriftFieldTests.table";
+  std::remove(table_file.c_str());
+  WriteUniformFieldMap(map_file);
+
+  SECTION("Drift interpolates the computed table") {
+    nexus::RadiusDependentDriftField field(0., 100.*mm, 200.*mm);
+    field.SetDriftVelocity(1.*mm/microsecond);
+    field.LoadDriftTable(table_file, map_file);
+
+    CheckDrift(field, 30.*mm, 50.*mm);
+    CheckDrift(field, 42.5*mm, 77.5*mm);
+
+    // Outside the drift region the electron doesn't move
+    G4LorentzVector xyzt(30.*mm, 0., 150.*mm, 0.);
+    REQUIRE(field.Drift(xyzt) == 0.);
+  }
+
+  SECTION("Table with the same parameters is reused") {
+    nexus::RadiusDependentDriftField field(0., 100.*mm, 200.*mm);
+    field.SetDriftVelocity(1.*mm/microsecond);
+    field.LoadDriftTable(table_file, map_file);
+
+    // No field map needed to load the stored table
+    nexus::RadiusDependentDriftField other(0., 100.*mm, 200.*mm);
+    other.SetDriftVelocity(1.*mm/microsecond);
+    other.LoadDriftTable(table_file);
+
+    CheckDrift(other, 30.*mm, 50.*mm);
+  }
+
+  SECTION("Table with other parameters is computed again") {
+    nexus::RadiusDependentDriftField field(0., 100.*mm, 200.*mm);
+    field.SetDriftVelocity(1.*mm/microsecond);
+    field.LoadDriftTable(table_file, map_file);
+
+    nexus::RadiusDependentDriftField other(0., 100.*mm, 200.*mm);
+    other.SetDriftVelocity(2.*mm/microsecond);
+    other.LoadDriftTable(table_file, map_file);
+
+    CheckDrift(other, 30.*mm, 50.*mm);
+  }
+
+  SECTION("Table computed from another field map is computed again") {
+    nexus::RadiusDependentDriftField field(0., 100.*mm, 200.*mm);
+    field.SetDriftVelocity(1.*mm/microsecond);
+    field.LoadDriftTable(table_file, map_file);
+
+    // Field at 45 degrees: the electron moves outward as much as it drifts
+    WriteUniformFieldMap(map_file, -1);
+    nexus::RadiusDependentDriftField other(0., 100.*mm, 200.*mm);
+    other.SetDriftVelocity(1.*mm/microsecond);
+    other.LoadDriftTable(table_file, map_file);
+
+    G4LorentzVector xyzt(30.*mm, 0., 50.*mm, 0.);
+    other.Drift(xyzt);
+    REQUIRE(xyzt.perp() == Approx(80.*mm).margin(1.e-3*mm));
+    REQUIRE(xyzt.t()    == Approx(std::sqrt(2.) * 50.*mm / (1.*mm/microsecond)).epsilon(1.e-4));
+  }
+
+  std::remove(table_file.c_str());
+  std::remove(map_file.c_str());
+}
@@ -41,3 +41,38 @@ TEST_CASE("Direction Function") {
   }
 
 }
+
+
+TEST_CASE("Alias sampler") {
+
+  // This test checks that the outcomes drawn by the alias sampler
+  // follow the normalized weights, and that outcomes with null weight
+  // are never drawn.
+
+  std::vector<G4double> weights = {0.5, 0., 3., 2., 0.25, 7.};
+  nexus::AliasSampler sampler(weights);
+
+  REQUIRE(sampler.GetSize() == weights.size());
+
+  G4double total = 0.;
+  for (auto w: weights) total += w;
+  for (size_t i=0; i<weights.size(); i++)
+    REQUIRE(sampler.GetProbability(i) == Approx(weights[i]/total));
+
+  // A uniform grid of random numbers maps onto
+  // each outcome in proportion to its probability
+  const G4int n = 100000;
+  std::vector<G4int> counts(weights.size(), 0);
+  for (G4int k=0; k<n; k++)
+    counts[sampler.Sample((k + 0.5)/n)]++;
+
+  for (size_t i=0; i<weights.size(); i++)
+    REQUIRE(counts[i]/G4double(n) == Approx(weights[i]/total).margin(1.e-4));
+
+  for (G4int k=0; k<n; k++) {
+    size_t i = sampler.Sample();
+    REQUIRE(i < weights.size());
+    REQUIRE(i != 1);
+  }
+
+}
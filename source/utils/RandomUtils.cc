@@ -11,6 +11,8 @@
 
 #include "CLHEP/Units/SystemOfUnits.h"
 
+#include <algorithm>
+
 namespace nexus {
 
   G4double UniformRandomInRange(G4double max_value, G4double min_value)
@@ -39,4 +41,84 @@ namespace nexus {
   }
 
 
+
+  AliasSampler::AliasSampler()
+  {
+  }
+
+
+
+  AliasSampler::AliasSampler(const std::vector<G4double>& weights)
+  {
+    SetWeights(weights);
+  }
+
+
+
+  void AliasSampler::SetWeights(const std::vector<G4double>& weights)
+  {
+    size_t n = weights.size();
+
+    G4double total = 0.;
+    for (auto w: weights) {
+      if (w < 0.)
+        G4Exception("[AliasSampler]", "SetWeights()", FatalException,
+                    "Weights must be non-negative.");
+      total += w;
+    }
+    if (n == 0 || total <= 0.)
+      G4Exception("[AliasSampler]", "SetWeights()", FatalException,
+                  "At least one weight must be positive.");
+
+    pdf_.resize(n);
+    prob_.resize(n);
+    alias_.resize(n);
+
+    // Split the columns, scaled so that their mean height is 1,
+    // into those below and above the mean (Vose's algorithm)
+    std::vector<size_t> small, large;
+    for (size_t i=0; i<n; ++i) {
+      pdf_[i]   = weights[i] / total;
+      prob_[i]  = pdf_[i] * n;
+      alias_[i] = i;
+      if (prob_[i] < 1.) small.push_back(i);
+      else large.push_back(i);
+    }
+
+    // Fill each small column with part of a large one
+    while (!small.empty() && !large.empty()) {
+      size_t s = small.back(); small.pop_back();
+      size_t l = large.back();
+      alias_[s] = l;
+      prob_[l] -= 1. - prob_[s];
+      if (prob_[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+
+    // The remaining columns are full, up to rounding errors
+    for (auto i: small) prob_[i] = 1.;
+    for (auto i: large) prob_[i] = 1.;
+  }
+
+
+
+  size_t AliasSampler::Sample() const
+  {
+    return Sample(G4UniformRand());
+  }
+
+
+
+  size_t AliasSampler::Sample(G4double u) const
+  {
+    // The integer part of u*n selects the column
+    // and the fractional part, the outcome within it
+    G4double x = u * prob_.size();
+    size_t i = std::min(static_cast<size_t>(x), prob_.size() - 1);
+    return (x - i < prob_[i]) ? i : alias_[i];
+  }
+
+
 }
@@ -8,6 +8,8 @@
 
 #include <G4ThreeVector.hh>
 
+#include <vector>
+
 
 #ifndef RAND_U_H
 #define RAND_U_H
@@ -19,6 +21,45 @@ namespace nexus {
   G4ThreeVector RandomDirectionInRange(G4double costheta_min, G4double costheta_max,
                                        G4double phi_min, G4double phi_max);
 
+
+  /// Sampler of discrete distributions using the alias method
+  /// (Walker, Vose): after building the tables from the weights
+  /// of the outcomes, which takes linear time, each draw takes
+  /// constant time and a single random number.
+
+  class AliasSampler
+  {
+  public:
+    /// Default constructor (empty sampler)
+    AliasSampler();
+    /// Constructor from the (not necessarily normalized)
+    /// weights of the outcomes, which must be non-negative
+    AliasSampler(const std::vector<G4double>& weights);
+
+    /// Build the tables for a new set of weights
+    void SetWeights(const std::vector<G4double>& weights);
+
+    /// Return a random outcome, as an index into the weights
+    size_t Sample() const;
+    /// Return the outcome corresponding to
+    /// the given uniform random number in [0, 1)
+    size_t Sample(G4double u) const;
+
+    /// Return the number of outcomes
+    size_t GetSize() const;
+    /// Return the normalized probability of an outcome
+    G4double GetProbability(size_t i) const;
+
+  private:
+    std::vector<G4double> prob_;  ///< Probability of keeping each column
+    std::vector<size_t>   alias_; ///< Alternative outcome of each column
+    std::vector<G4double> pdf_;   ///< Normalized probabilities
+  };
+
+  inline size_t AliasSampler::GetSize() const { return pdf_.size(); }
+
+  inline G4double AliasSampler::GetProbability(size_t i) const { return pdf_[i]; }
+
 }
 
 #endif
@@ -1,3 +1,6 @@
+import os
+import subprocess
+
 import pandas as pd
 import tables as tb
 import numpy as np
@@ -15,6 +18,7 @@ def test_hdf5_structure(detectors):
             assert 'sns_response'  in h5out.root.MC
             assert 'configuration' in h5out.root.MC
             assert 'sns_positions' in h5out.root.MC
+            assert 'event_index'   in h5out.root.MC
 
 
             pcolumns = h5out.root.MC.particles.colnames
@@ -44,6 +48,7 @@ def test_hdf5_structure(detectors):
             assert 'length'             in pcolumns
             assert 'creator_proc'       in pcolumns
             assert 'final_proc'         in pcolumns
+            assert 'weight'             in pcolumns
 
 
             hcolumns = h5out.root.MC.hits.colnames
@@ -107,6 +112,32 @@ def test_particle_ids_of_hits_exist_in_particle_table(detectors):
         test(filename)
 
 
+def test_event_index_matches_tables(detectors):
+    """
+    Check that the rows given by the event index for each
+    event contain the event and only the event.
+    """
+
+    def test(filename):
+        index     = pd.read_hdf(filename, 'MC/event_index')
+        particles = pd.read_hdf(filename, 'MC/particles')
+        hits      = pd.read_hdf(filename, 'MC/hits')
+
+        for table, name in [(particles, 'particle'), (hits, 'hit')]:
+            first = index['first_' + name].values
+            count = index['n_'     + name + 's'].values
+            assert count.sum() == len(table)
+            for evt, start, n in zip(index.event_id.values, first, count):
+                assert np.all(table.event_id.values[start:start+n] == evt)
+
+    filename, _, _, _, _ = detectors
+    if "DEMOPP" in filename:
+        for run in ["run5", "run7", "run8", "run9", "run10"]:
+            test(filename.format(run=run))
+    else:
+        test(filename)
+
+
 def test_hit_labels(detectors):
     """Check that there is at least one hit in the ACTIVE volume."""
 
@@ -184,3 +215,36 @@ def test_sensor_names_are_the_same_across_tables(detectors):
             test(filename.format(run=run))
     else:
         test(filename)
+
+
+def test_merge_keeps_configuration(nexus_full_output_file_next100,
+                                   output_tmpdir, NEXUSDIR):
+    """
+    Check that merging a file with itself keeps every configuration
+    row, including repeated keys, and sums the event counters.
+    """
+    filename = nexus_full_output_file_next100
+    merged   = os.path.join(output_tmpdir, 'merged.h5')
+
+    merge_exe = NEXUSDIR + '/bin/nexus-merge'
+    command   = [merge_exe, '-r', '-o', merged, filename, filename]
+    p = subprocess.run(command, check=True, stderr=subprocess.PIPE)
+    assert b'differs' not in p.stderr
+
+    counters = ['num_events', 'saved_events', 'interacting_events']
+
+    config = pd.read_hdf(filename, 'MC/configuration')
+    merged_config = pd.read_hdf(merged, 'MC/configuration')
+
+    others        = config[~config.param_key.isin(counters)]
+    merged_others = merged_config[~merged_config.param_key.isin(counters)]
+    assert np.all(others.param_key.values   == merged_others.param_key.values)
+    assert np.all(others.param_value.values == merged_others.param_value.values)
+    assert (config.param_key == '/PhysicsList/RegisterPhysics').sum() > 1
+
+    for key in counters:
+        value  = config[config.param_key == key].param_value.values
+        mvalue = merged_config[merged_config.param_key == key].param_value.values
+        assert len(mvalue) == len(value)
+        if len(value):
+            assert int(mvalue[0]) == 2 * int(value[0])